@@ -0,0 +1,151 @@
+#include "ConvolutionReverb.h"
+
+namespace
+{
+    juce::AudioBuffer<float> resampleImpulse(const juce::AudioBuffer<float>& source, double sourceRate, double targetRate)
+    {
+        if (std::abs(sourceRate - targetRate) < 1.0e-3)
+            return source;
+
+        // ResamplingAudioSource low-passes first when the impulse was
+        // recorded at a higher rate than the session
+        const double ratio = sourceRate / targetRate;
+        const int length = static_cast<int>(std::ceil(source.getNumSamples() / ratio));
+
+        juce::AudioBuffer<float> sourceCopy(source);
+        juce::MemoryAudioSource memorySource(sourceCopy, false);
+        juce::ResamplingAudioSource resampler(&memorySource, false, source.getNumChannels());
+        resampler.setResamplingRatio(ratio);
+        resampler.prepareToPlay(length, targetRate);
+
+        juce::AudioBuffer<float> result(source.getNumChannels(), length);
+        resampler.getNextAudioBlock(juce::AudioSourceChannelInfo(&result, 0, length));
+        return result;
+    }
+
+    void normaliseImpulse(juce::AudioBuffer<float>& buffer)
+    {
+        // Unit energy on the louder channel puts impulses of any length or
+        // level at roughly the loudness of the input
+        double maxEnergy = 0.0;
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            const float* samples = buffer.getReadPointer(channel);
+            double energy = 0.0;
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                energy += static_cast<double>(samples[i]) * samples[i];
+
+            maxEnergy = juce::jmax(maxEnergy, energy);
+        }
+
+        if (maxEnergy > 0.0)
+            buffer.applyGain(static_cast<float>(1.0 / std::sqrt(maxEnergy)));
+    }
+}
+
+void ConvolutionReverb::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    {
+        const juce::ScopedLock sl(impulseLock);
+        preparedSpec = spec;
+    }
+
+    rebuild();
+}
+
+void ConvolutionReverb::reset()
+{
+    audioThreadBusy.store(true);
+
+    if (auto* current = activeConvolver.load())
+        current->reset();
+
+    audioThreadBusy.store(false);
+}
+
+bool ConvolutionReverb::loadImpulseResponse(const juce::File& file)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+        return false;
+
+    const int numChannels = juce::jmin(2, static_cast<int>(reader->numChannels));
+    const auto maxLength = static_cast<juce::int64>(reader->sampleRate * maxImpulseSeconds);
+    const int length = static_cast<int>(juce::jmin(reader->lengthInSamples, maxLength));
+
+    juce::AudioBuffer<float> loaded(numChannels, length);
+    reader->read(&loaded, 0, length, 0, true, numChannels > 1);
+
+    // Fade out rather than cut off an impulse that was too long
+    if (reader->lengthInSamples > maxLength)
+    {
+        const int fadeLength = juce::jmin(length, static_cast<int>(reader->sampleRate * 0.05));
+        loaded.applyGainRamp(length - fadeLength, fadeLength, 1.0f, 0.0f);
+    }
+
+    setImpulseResponse(loaded, reader->sampleRate);
+    return true;
+}
+
+void ConvolutionReverb::setImpulseResponse(const juce::AudioBuffer<float>& newImpulse, double newSampleRate)
+{
+    {
+        const juce::ScopedLock sl(impulseLock);
+        impulse.makeCopyOf(newImpulse);
+        impulseSampleRate = newSampleRate;
+    }
+
+    rebuild();
+}
+
+void ConvolutionReverb::rebuild()
+{
+    std::unique_ptr<PartitionedConvolver> newConvolver;
+
+    {
+        const juce::ScopedLock sl(impulseLock);
+
+        if (preparedSpec.sampleRate > 0.0 && impulse.getNumSamples() > 0)
+        {
+            auto resampled = resampleImpulse(impulse, impulseSampleRate, preparedSpec.sampleRate);
+            normaliseImpulse(resampled);
+
+            newConvolver = std::make_unique<PartitionedConvolver>(resampled,
+                static_cast<int>(preparedSpec.numChannels),
+                static_cast<int>(preparedSpec.maximumBlockSize));
+        }
+
+        impulseLength.store(newConvolver != nullptr ? newConvolver->getImpulseLength() : 0, std::memory_order_relaxed);
+
+        // Once the new convolver is published, the audio thread can only
+        // still hold the old one if it is in the middle of a block
+        activeConvolver.store(newConvolver.get());
+        while (audioThreadBusy.load())
+            juce::Thread::yield();
+
+        convolver.swap(newConvolver);
+    }
+
+    // The old convolver and its tail thread are released here, not on the audio thread
+}
+
+void ConvolutionReverb::process(juce::dsp::AudioBlock<float>& block)
+{
+    audioThreadBusy.store(true);
+
+    if (auto* current = activeConvolver.load())
+    {
+        current->setNonRealtime(nonRealtime.load(std::memory_order_relaxed));
+        current->process(block);
+    }
+    else
+    {
+        block.clear();
+    }
+
+    audioThreadBusy.store(false);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "PartitionedConvolver.h"
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Impulse-response reverb
+ *
+ * Loads an impulse response from a WAV file, resamples it to the session
+ * rate in prepare() and runs it through a PartitionedConvolver. A new
+ * impulse is partitioned on the calling thread and published to the audio
+ * thread through an atomic pointer; the old one is freed once the audio
+ * thread has let go of it. The output is fully wet.
+ */
+class ConvolutionReverb
+{
+public:
+    ConvolutionReverb() = default;
+    ~ConvolutionReverb() = default;
+
+    //==============================================================================
+    /** Prepares the processor for playback, resampling the impulse to the new rate */
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    /** Clears the convolution history; safe to call from the audio thread */
+    void reset();
+
+    //==============================================================================
+    /** Loads an impulse response (up to 10s) from a WAV file; returns false if it can't be read */
+    bool loadImpulseResponse(const juce::File& file);
+
+    /** Replaces the impulse response; call off the audio thread */
+    void setImpulseResponse(const juce::AudioBuffer<float>& newImpulse, double newSampleRate);
+
+    /** Makes late tail blocks wait rather than drop out, for offline rendering */
+    void setNonRealtime(bool shouldBeNonRealtime) noexcept { nonRealtime.store(shouldBeNonRealtime, std::memory_order_relaxed); }
+
+    /** Returns the impulse length at the session rate, or 0 if none is loaded */
+    int getImpulseLengthSamples() const noexcept { return impulseLength.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    /** Processes a mono or stereo block in place */
+    void process(juce::dsp::AudioBlock<float>& block);
+
+private:
+    //==============================================================================
+    static constexpr double maxImpulseSeconds = 10.0;
+
+    // Owned here, published to the audio thread through activeConvolver.
+    // audioThreadBusy covers the audio thread's use of the pointer, so a
+    // rebuild knows when the one it replaced can go
+    std::unique_ptr<PartitionedConvolver> convolver;
+    std::atomic<PartitionedConvolver*> activeConvolver { nullptr };
+    std::atomic<bool> audioThreadBusy { false };
+
+    // The impulse as loaded, at its own sample rate
+    juce::CriticalSection impulseLock;
+    juce::AudioBuffer<float> impulse;
+    double impulseSampleRate = 0.0;
+
+    juce::dsp::ProcessSpec preparedSpec { 0.0, 0, 0 };
+    std::atomic<int> impulseLength { 0 };
+    std::atomic<bool> nonRealtime { false };
+
+    //==============================================================================
+    void rebuild();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionReverb)
+};
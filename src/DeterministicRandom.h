@@ -0,0 +1,77 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+// Counter-based random generator: value n is a pure hash of (key, n), so a
+// given seed always reproduces the same sequence and block fills have no
+// loop-carried state, which lets the compiler vectorise them. The hash is
+// the 32-bit lowbias32 integer finaliser.
+class DeterministicRandom
+{
+public:
+    // Used until setSeed() is called, so a fresh instance is reproducible too
+    static constexpr juce::uint64 defaultSeed = 0x5eed;
+
+    explicit DeterministicRandom(juce::uint64 seed = defaultSeed) { setSeed(seed); }
+
+    void setSeed(juce::uint64 newSeed)
+    {
+        seed = newSeed;
+
+        // Fold the 64-bit seed into the 32-bit key with a SplitMix64 step
+        auto z = newSeed + 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        key = static_cast<juce::uint32>(z ^ (z >> 31));
+
+        counter = 0;
+    }
+
+    juce::uint64 getSeed() const noexcept { return seed; }
+
+    // Rewinds to the start of the sequence for the current seed
+    void reset() noexcept { counter = 0; }
+
+    juce::uint32 nextUInt32() noexcept { return hash(key, counter++); }
+
+    float nextFloat() noexcept { return toUnitFloat(nextUInt32()); }                // [0, 1)
+    float nextBipolar() noexcept { return toUnitFloat(nextUInt32()) * 2.0f - 1.0f; } // [-1, 1)
+    bool nextBool() noexcept { return (nextUInt32() & 0x80000000u) != 0; }
+
+    void fillUniform(float* dest, int numSamples) noexcept
+    {
+        const auto base = counter;
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = toUnitFloat(hash(key, base + static_cast<juce::uint32>(i)));
+        counter = base + static_cast<juce::uint32>(numSamples);
+    }
+
+    void fillBipolar(float* dest, int numSamples) noexcept
+    {
+        const auto base = counter;
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = toUnitFloat(hash(key, base + static_cast<juce::uint32>(i))) * 2.0f - 1.0f;
+        counter = base + static_cast<juce::uint32>(numSamples);
+    }
+
+private:
+    static juce::uint32 hash(juce::uint32 k, juce::uint32 n) noexcept
+    {
+        auto x = n * 0x9e3779b9u + k;
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    static float toUnitFloat(juce::uint32 x) noexcept
+    {
+        // Top 24 bits, exactly representable in a float mantissa
+        return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+    }
+
+    juce::uint64 seed = 0;
+    juce::uint32 key = 0;
+    juce::uint32 counter = 0;
+};
@@ -1,20 +1,119 @@
 #include "ExciterSaturation.h"
+#include "WaveshaperTables.h"
 #include <cmath>
 
+namespace
+{
+    // Shapes with closed-form first and second antiderivatives, in double so
+    // the ADAA divided differences keep their precision for small steps
+
+    // tanh, F1 = log cosh, F2 = integral of log cosh from 0
+    struct TanhShape
+    {
+        static double f(double x) { return std::tanh(x); }
+
+        static double F1(double x)
+        {
+            // log cosh x = |x| - log 2 + log(1 + e^-2|x|), safe for large |x|
+            const double a = std::abs(x);
+            return a - ln2 + std::log1p(std::exp(-2.0 * a));
+        }
+
+        static double F2(double x)
+        {
+            // For x >= 0: x^2/2 - x log 2 + Li2(-e^-2x)/2 + pi^2/24, odd in x
+            const double a = std::abs(x);
+            const double value = 0.5 * a * a - a * ln2
+                + 0.5 * dilogarithm(-std::exp(-2.0 * a))
+                + juce::MathConstants<double>::pi * juce::MathConstants<double>::pi / 24.0;
+            return x < 0.0 ? -value : value;
+        }
+
+        static constexpr double ln2 = 0.69314718055994530942;
+
+        // Li2(z) for z in [-1, 0]. The Landen identity
+        // Li2(z) = -Li2(z / (z - 1)) - log^2(1 - z) / 2 maps the argument into
+        // [0, 0.5], where the power series converges to double precision in
+        // at most ~45 terms (far fewer for the large |x| most samples sit at)
+        static double dilogarithm(double z)
+        {
+            const double t = z / (z - 1.0);
+            double power = t;
+            double sum = 0.0;
+
+            for (int k = 1; k < 64 && power > 1.0e-17 * k * k; ++k)
+            {
+                sum += power / static_cast<double>(k * k);
+                power *= t;
+            }
+
+            const double log1mz = std::log1p(-z);
+            return -sum - 0.5 * log1mz * log1mz;
+        }
+    };
+
+    // x - 0.15x^3, the transformer curve
+    struct CubicShape
+    {
+        static double f(double x) { return x * (1.0 - 0.15 * x * x); }
+        static double F1(double x) { const double x2 = x * x; return x2 * (0.5 - 0.0375 * x2); }
+        static double F2(double x) { const double x2 = x * x; return x * x2 * (1.0 / 6.0 - 0.0075 * x2); }
+    };
+
+    // Below this step the divided differences are ill-conditioned and the
+    // midpoint rule is used instead
+    constexpr double antialiasTolerance = 1.0e-5;
+}
+
 ExciterSaturation::ExciterSaturation()
-    : oversampling(2, 1, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, false)
 {
+    updateChebyshevPolynomial();
+
+    // Integer latency so the dry path can be aligned with a plain delay
+    using Oversampler = juce::dsp::Oversampling<float>;
+
+    for (auto& slot : oversamplers)
+    {
+        for (int stages = 1; stages <= maxOversamplingStages; ++stages)
+        {
+            const auto index = static_cast<size_t>(stages - 1);
+            slot[index] = std::make_unique<Oversampler>(
+                2, static_cast<size_t>(stages), Oversampler::filterHalfBandPolyphaseIIR, true, true);
+            slot[index + maxOversamplingStages] = std::make_unique<Oversampler>(
+                2, static_cast<size_t>(stages), Oversampler::filterHalfBandFIREquiripple, true, true);
+        }
+    }
+
+    for (auto& allpass : crossoverAllpasses)
+        allpass.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+}
+
+juce::dsp::Oversampling<float>* ExciterSaturation::getOversampler(int stages, OversamplingFilter filter, int slot) const
+{
+    if (stages <= 0)
+        return nullptr;
+
+    const int offset = filter == OversamplingFilter::LinearPhaseFIR ? maxOversamplingStages : 0;
+    return oversamplers[static_cast<size_t>(slot)][static_cast<size_t>(offset + stages - 1)].get();
 }
 
 void ExciterSaturation::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = static_cast<float>(spec.sampleRate);
 
-    // Prepare oversampling
-    oversampling.initProcessing(spec.maximumBlockSize);
+    // Prepare every oversampler; anything pending takes effect immediately
+    for (auto& slot : oversamplers)
+        for (auto& oversampler : slot)
+            oversampler->initProcessing(spec.maximumBlockSize);
+
+    oversamplingStages = pendingOversamplingStages;
+    oversamplingFilter = pendingOversamplingFilter;
+    antialiasing = pendingAntialiasing;
+    numBands = pendingNumBands;
+
     juce::dsp::ProcessSpec oversampledSpec = spec;
-    oversampledSpec.sampleRate *= 2.0;
-    oversampledSpec.maximumBlockSize *= 2;
+    oversampledSpec.sampleRate *= static_cast<double>(1 << maxOversamplingStages);
+    oversampledSpec.maximumBlockSize <<= maxOversamplingStages;
 
     // Prepare all filters
     highpass.prepare(oversampledSpec);
@@ -22,43 +121,94 @@ void ExciterSaturation::prepare(const juce::dsp::ProcessSpec& spec)
     deEmphasis.prepare(oversampledSpec);
     dcBlocker.prepare(oversampledSpec);
     toneFilter.prepare(spec);  // Tone filter at normal rate
+    bandDcBlocker.prepare(spec);
+
+    for (auto& crossover : crossovers)
+        crossover.prepare(spec);
+    for (auto& allpass : crossoverAllpasses)
+        allpass.prepare(spec);
 
-    // Initialize filter coefficients
+    // Initialize filter coefficients for the current oversampling factor
     updateHighpass();
     updatePreEmphasis();
     updateDeEmphasis();
     updateToneFilter();
+    updateDcBlocker();
+    updateCrossovers();
 
-    // DC blocker at 5Hz
-    *dcBlocker.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(
-        oversampledSpec.sampleRate, 5.0);
+    for (int band = 0; band < maxBands; ++band)
+        bandOversampled[static_cast<size_t>(band)] = numBands > 1 && bandNeedsOversampling(band);
 
-    // Prepare smoothed parameters
-    smoothedDrive.reset(sampleRate, 0.02);      // 20ms ramp
+    // Prepare smoothed parameters; drive is consumed per shaped sample
+    smoothedDrive.reset(getProcessingRate(), 0.02);      // 20ms ramp
     smoothedMix.reset(sampleRate, 0.02);
     smoothedDrive.setCurrentAndTargetValue(drive);
     smoothedMix.setCurrentAndTargetValue(mix);
+    switchGain.reset(sampleRate, 0.005);                // 5ms duck either side of a switch
+    updateEnvelopeCoeff();
+    switchGain.setCurrentAndTargetValue(1.0f);
+
+    // The dry delay covers the longest latency of any oversampler, plus at
+    // most one sample of ADAA delay
+    int maxLatency = 0;
+    for (auto& oversampler : oversamplers[0])
+        maxLatency = juce::jmax(maxLatency, static_cast<int>(std::ceil(oversampler->getLatencyInSamples())));
+
+    dryDelay.setMaximumDelayInSamples(maxLatency + 2);
+    dryDelay.prepare(spec);
+
+    for (auto& band : bands)
+    {
+        band.buffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+        band.dryAlignment.setMaximumDelayInSamples(maxLatency + 2);
+        band.dryAlignment.prepare(spec);
+        band.alignment.setMaximumDelayInSamples(maxLatency + 2);
+        band.alignment.prepare(spec);
+        band.smoothedMix.reset(sampleRate, 0.02);
+        band.smoothedMix.setCurrentAndTargetValue(band.mix);
+        band.processingRate = 0.0f;     // Drive smoothing is set up on first use
+    }
 
     // Allocate buffers
-    dryBuffer.setSize(static_cast<int>(spec.numChannels),
+    wetBuffer.setSize(static_cast<int>(spec.numChannels),
         static_cast<int>(spec.maximumBlockSize));
     oversampledBuffer.setSize(static_cast<int>(spec.numChannels),
         static_cast<int>(oversampledSpec.maximumBlockSize));
+    bandDryBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    driveRamp.assign(oversampledSpec.maximumBlockSize, 1.0f);
+    switchRamp.assign(spec.maximumBlockSize, 1.0f);
+    numPreparedChannels = static_cast<int>(spec.numChannels);
+    antialiasStates.assign(static_cast<size_t>(maxBands * numPreparedChannels), AntialiasState{});
 
     reset();
 }
 
 void ExciterSaturation::reset()
 {
-    oversampling.reset();
+    for (auto& slot : oversamplers)
+        for (auto& oversampler : slot)
+            oversampler->reset();
+
+    dryDelay.reset();
+    dryDelay.setDelay(getWetLatency());
+    previousDryLatency = -1.0f;
+    updateBandAlignment();
+
+    for (auto& crossover : crossovers)
+        crossover.reset();
+    for (auto& allpass : crossoverAllpasses)
+        allpass.reset();
+
+    bandDcBlocker.reset();
     highpass.reset();
     preEmphasis.reset();
     deEmphasis.reset();
     dcBlocker.reset();
     toneFilter.reset();
+    std::fill(antialiasStates.begin(), antialiasStates.end(), AntialiasState{});
 
-    inputRMS.fill(0.0f);
-    outputRMS.fill(0.0f);
+    inputEnvelope = 0.0f;
+    outputEnvelope = 0.0f;
 }
 
 void ExciterSaturation::setDrive(float newDrive)
@@ -107,36 +257,308 @@ void ExciterSaturation::setAutoGainEnabled(bool enabled)
     autoGainEnabled = enabled;
 }
 
+void ExciterSaturation::setAutoGainTime(float timeMs)
+{
+    autoGainTimeMs = juce::jlimit(10.0f, 2000.0f, timeMs);
+    updateEnvelopeCoeff();
+}
+
+void ExciterSaturation::updateEnvelopeCoeff()
+{
+    envelopeCoeff = 1.0f - std::exp(-1000.0f / (autoGainTimeMs * sampleRate));
+}
+
+void ExciterSaturation::setAntialiasing(Antialiasing newAntialiasing)
+{
+    // Takes effect in process() once the wet path has ducked, since the ADAA
+    // delay is part of the latency
+    pendingAntialiasing = newAntialiasing;
+}
+
+void ExciterSaturation::setOversamplingFactor(int newFactor)
+{
+    // Takes effect in process() once the wet path has ducked
+    pendingOversamplingStages = newFactor >= 8 ? 3 : newFactor >= 4 ? 2 : newFactor >= 2 ? 1 : 0;
+}
+
+void ExciterSaturation::setOversamplingFilter(OversamplingFilter newFilter)
+{
+    pendingOversamplingFilter = newFilter;
+}
+
+void ExciterSaturation::setLookupTablesEnabled(bool enabled)
+{
+    lookupTablesEnabled = enabled;
+}
+
+void ExciterSaturation::setChebyshevGain(int order, float gain)
+{
+    if (order < 2 || order > maxChebyshevOrder)
+        return;
+
+    // Set every block from the parameters, so only a change rebuilds the polynomial
+    gain = juce::jlimit(-1.0f, 1.0f, gain);
+    if (chebyshevGains[static_cast<size_t>(order - 2)] == gain)
+        return;
+
+    chebyshevGains[static_cast<size_t>(order - 2)] = gain;
+    updateChebyshevPolynomial();
+}
+
+float ExciterSaturation::getChebyshevGain(int order) const
+{
+    if (order < 2 || order > maxChebyshevOrder)
+        return 0.0f;
+
+    return chebyshevGains[static_cast<size_t>(order - 2)];
+}
+
+void ExciterSaturation::updateChebyshevPolynomial()
+{
+    // Power-series coefficients of T0..T8 via T(k+1) = 2x T(k) - T(k-1)
+    std::array<std::array<double, maxChebyshevOrder + 1>, maxChebyshevOrder + 1> t {};
+    t[0][0] = 1.0;
+    t[1][1] = 1.0;
+
+    for (size_t k = 1; k < maxChebyshevOrder; ++k)
+        for (size_t n = 0; n <= maxChebyshevOrder; ++n)
+            t[k + 1][n] = (n > 0 ? 2.0 * t[k][n - 1] : 0.0) - t[k - 1][n];
+
+    std::array<double, maxChebyshevOrder + 1> sum {};
+    for (size_t order = 2; order <= maxChebyshevOrder; ++order)
+        for (size_t n = 0; n <= maxChebyshevOrder; ++n)
+            sum[n] += chebyshevGains[order - 2] * t[order][n];
+
+    // Drop the constant so silence stays silent; the DC blocker takes the rest
+    sum[0] = 0.0;
+
+    for (size_t n = 0; n <= maxChebyshevOrder; ++n)
+        chebyshevPolynomial[n] = static_cast<float>(sum[n]);
+}
+
+int ExciterSaturation::getRecommendedOversamplingFactor() const
+{
+    if (harmonicMode != HarmonicMode::Chebyshev)
+        return 2;
+
+    int highestOrder = 1;
+    for (int order = 2; order <= maxChebyshevOrder; ++order)
+        if (chebyshevGains[static_cast<size_t>(order - 2)] != 0.0f)
+            highestOrder = order;
+
+    // Harmonic N of a tone below fs/4 stays clear of the audible band once
+    // N * fs/4 < (factor - 1/2) * fs, i.e. factor >= (N + 2) / 4
+    const int required = (highestOrder + 2 + 3) / 4;
+    return juce::nextPowerOfTwo(required);
+}
+
+float ExciterSaturation::getAntialiasingDelay() const
+{
+    if (antialiasing == Antialiasing::SecondOrder)
+        return 1.0f;
+
+    return antialiasing == Antialiasing::FirstOrder ? 0.5f : 0.0f;
+}
+
+float ExciterSaturation::getWetLatency() const
+{
+    // At 1x the ADAA delay is compensated exactly, half samples included
+    const float antialiasingDelay = getAntialiasingDelay();
+
+    if (auto* oversampler = getOversampler(oversamplingStages, oversamplingFilter))
+        return static_cast<float>(juce::roundToInt(oversampler->getLatencyInSamples()
+            + antialiasingDelay / static_cast<float>(1 << oversamplingStages)));
+
+    return antialiasingDelay;
+}
+
+int ExciterSaturation::getLatencySamples() const
+{
+    // First-order ADAA at 1x leaves a half sample the host can't be told about
+    return juce::roundToInt(getWetLatency());
+}
+
+void ExciterSaturation::setNumBands(int newNumBands)
+{
+    // Takes effect in process() once the wet path has ducked
+    pendingNumBands = juce::jlimit(1, maxBands, newNumBands);
+}
+
+void ExciterSaturation::setCrossoverFrequency(int index, float freqHz)
+{
+    if (index < 0 || index >= maxBands - 1)
+        return;
+
+    freqHz = juce::jlimit(20.0f, 20000.0f, freqHz);
+    if (crossoverFrequencies[static_cast<size_t>(index)] == freqHz)
+        return;
+
+    crossoverFrequencies[static_cast<size_t>(index)] = freqHz;
+    updateCrossovers();
+}
+
+void ExciterSaturation::setBandDrive(int band, float newDrive)
+{
+    if (band < 0 || band >= maxBands)
+        return;
+
+    auto& b = bands[static_cast<size_t>(band)];
+    b.drive = juce::jlimit(0.0f, 1.0f, newDrive);
+    b.smoothedDrive.setTargetValue(b.drive);
+}
+
+void ExciterSaturation::setBandMix(int band, float newMix)
+{
+    if (band < 0 || band >= maxBands)
+        return;
+
+    auto& b = bands[static_cast<size_t>(band)];
+    b.mix = juce::jlimit(0.0f, 1.0f, newMix);
+    b.smoothedMix.setTargetValue(b.mix);
+}
+
+void ExciterSaturation::setBandSaturationType(int band, SaturationType type)
+{
+    if (band < 0 || band >= maxBands)
+        return;
+
+    bands[static_cast<size_t>(band)].saturationType = type;
+}
+
+void ExciterSaturation::updateCrossovers()
+{
+    // Only the active crossovers are sorted, so a 2-band split always uses
+    // the first frequency whatever the others are set to
+    activeCrossovers = crossoverFrequencies;
+    std::sort(activeCrossovers.begin(), activeCrossovers.begin() + juce::jmax(0, numBands - 1));
+
+    const float limit = sampleRate * 0.45f;
+    for (size_t k = 0; k < crossovers.size(); ++k)
+        crossovers[k].setCutoffFrequency(juce::jmin(activeCrossovers[k], limit));
+
+    crossoverAllpasses[0].setCutoffFrequency(juce::jmin(activeCrossovers[1], limit));  // Band 0 at crossover 1
+    crossoverAllpasses[1].setCutoffFrequency(juce::jmin(activeCrossovers[2], limit));  // Band 0 at crossover 2
+    crossoverAllpasses[2].setCutoffFrequency(juce::jmin(activeCrossovers[2], limit));  // Band 1 at crossover 2
+}
+
+void ExciterSaturation::updateBandAlignment()
+{
+    // Every band leaves with the wet path's latency. An oversampled band's
+    // wet already has it and a 1x band's wet has only the ADAA delay; the
+    // band's dry is delayed to its wet before the band mix, and the mixed
+    // band by whatever is left
+    const float latency = getWetLatency();
+
+    for (int band = 0; band < maxBands; ++band)
+    {
+        auto& b = bands[static_cast<size_t>(band)];
+        const bool oversampled = bandOversampled[static_cast<size_t>(band)]
+            && getOversampler(oversamplingStages, oversamplingFilter, band) != nullptr;
+        const float bandLatency = oversampled ? latency : getAntialiasingDelay();
+
+        b.dryAlignment.reset();
+        b.dryAlignment.setDelay(bandLatency);
+        b.alignment.reset();
+        b.alignment.setDelay(juce::jmax(0.0f, latency - bandLatency));
+    }
+}
+
+bool ExciterSaturation::bandNeedsOversampling(int band) const
+{
+    // Up to the 4th harmonic of a band topping out below fs/8 stays below
+    // Nyquist; the top band always reaches it. An oversampled band only drops
+    // back to 1x below fs/10, so a crossover automated around fs/8 doesn't
+    // keep switching it
+    if (band == numBands - 1)
+        return true;
+
+    const float threshold = bandOversampled[static_cast<size_t>(band)] ? sampleRate / 10.0f : sampleRate / 8.0f;
+    return activeCrossovers[static_cast<size_t>(band)] > threshold;
+}
+
+bool ExciterSaturation::hasPendingChange() const
+{
+    if (pendingOversamplingStages != oversamplingStages || pendingOversamplingFilter != oversamplingFilter
+        || pendingAntialiasing != antialiasing || pendingNumBands != numBands)
+        return true;
+
+    // A crossover move can take a band in or out of oversampling
+    if (numBands > 1)
+        for (int band = 0; band < numBands; ++band)
+            if (bandOversampled[static_cast<size_t>(band)] != bandNeedsOversampling(band))
+                return true;
+
+    return false;
+}
+
+void ExciterSaturation::applyPendingChange()
+{
+    oversamplingStages = pendingOversamplingStages;
+    oversamplingFilter = pendingOversamplingFilter;
+    antialiasing = pendingAntialiasing;
+    numBands = pendingNumBands;
+
+    updateCrossovers();
+    for (int band = 0; band < maxBands; ++band)
+        bandOversampled[static_cast<size_t>(band)] = numBands > 1 && bandNeedsOversampling(band);
+
+    // Everything between the up- and downsampler runs at the new rate
+    updateHighpass();
+    updatePreEmphasis();
+    updateDeEmphasis();
+    updateDcBlocker();
+    smoothedDrive.reset(getProcessingRate(), 0.02);
+
+    for (int slot = 0; slot < maxBands; ++slot)
+        if (auto* oversampler = getOversampler(oversamplingStages, oversamplingFilter, slot))
+            oversampler->reset();
+
+    highpass.reset();
+    preEmphasis.reset();
+    deEmphasis.reset();
+    dcBlocker.reset();
+    std::fill(antialiasStates.begin(), antialiasStates.end(), AntialiasState{});
+
+    // The dry delay keeps its history; process() fades it across from the
+    // old latency to the new one
+    dryDelay.setDelay(getWetLatency());
+    updateBandAlignment();
+
+    for (auto& crossover : crossovers)
+        crossover.reset();
+    for (auto& allpass : crossoverAllpasses)
+        allpass.reset();
+
+    bandDcBlocker.reset();
+}
+
 void ExciterSaturation::updateHighpass()
 {
-    float oversampledRate = sampleRate * 2.0f;
-    *highpass.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(
-        oversampledRate, highpassFreq);
+    *highpass.state = juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(
+        getProcessingRate(), highpassFreq);
 }
 
 void ExciterSaturation::updatePreEmphasis()
 {
     // Pre-emphasis: boost highs before saturation for air/presence
-    float oversampledRate = sampleRate * 2.0f;
     float emphasisFreq = juce::jmap(toneBrightness, 3000.0f, 8000.0f);
     float emphasisQ = 0.7f;
     float emphasisGain = juce::jmap(toneBrightness, 0.0f, 6.0f);  // Up to +6dB
 
-    *preEmphasis.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        oversampledRate, emphasisFreq, emphasisQ,
+    *preEmphasis.state = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(
+        getProcessingRate(), emphasisFreq, emphasisQ,
         juce::Decibels::decibelsToGain(emphasisGain));
 }
 
 void ExciterSaturation::updateDeEmphasis()
 {
     // De-emphasis: compensate for pre-emphasis boost
-    float oversampledRate = sampleRate * 2.0f;
     float emphasisFreq = juce::jmap(toneBrightness, 3000.0f, 8000.0f);
     float emphasisQ = 0.7f;
     float emphasisGain = juce::jmap(toneBrightness, 0.0f, 6.0f);
 
-    *deEmphasis.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        oversampledRate, emphasisFreq, emphasisQ,
+    *deEmphasis.state = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(
+        getProcessingRate(), emphasisFreq, emphasisQ,
         juce::Decibels::decibelsToGain(-emphasisGain * 0.5f));  // Partial compensation
 }
 
@@ -146,49 +568,33 @@ void ExciterSaturation::updateToneFilter()
     float toneFreq = juce::jmap(harmonicBalance, 2000.0f, 8000.0f);
     float toneGain = juce::jmap(harmonicBalance, -3.0f, 3.0f);
 
-    *toneFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(
+    *toneFilter.state = juce::dsp::IIR::ArrayCoefficients<float>::makeHighShelf(
         sampleRate, toneFreq, 0.7f, juce::Decibels::decibelsToGain(toneGain));
 }
 
-float ExciterSaturation::calculateGainCompensation()
+void ExciterSaturation::updateDcBlocker()
 {
-    if (!autoGainEnabled)
-        return 1.0f;
-
-    // Calculate average RMS across channels
-    float avgInputRMS = 0.0f;
-    float avgOutputRMS = 0.0f;
-    int numChannels = 0;
-
-    for (size_t i = 0; i < inputRMS.size(); ++i)
-    {
-        if (inputRMS[i] > 0.0f)
-        {
-            avgInputRMS += inputRMS[i];
-            avgOutputRMS += outputRMS[i];
-            ++numChannels;
-        }
-    }
-
-    if (numChannels == 0)
-        return 1.0f;
-
-    avgInputRMS /= static_cast<float>(numChannels);
-    avgOutputRMS /= static_cast<float>(numChannels);
-
-    // Prevent division by zero
-    if (avgOutputRMS < 0.0001f)
-        return 1.0f;
+    // DC blocker at 5Hz
+    *dcBlocker.state = juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(
+        getProcessingRate(), 5.0f);
+    *bandDcBlocker.state = juce::dsp::IIR::ArrayCoefficients<float>::makeHighPass(
+        sampleRate, 5.0f);
+}
 
-    // Calculate gain compensation with limiting
-    float compensation = avgInputRMS / avgOutputRMS;
-    return juce::jlimit(0.5f, 2.0f, compensation);  // Limit to 6dB
+template <bool UseTables>
+float ExciterSaturation::saturate(float x)
+{
+    if constexpr (UseTables)
+        return WaveshaperTables::Tanh::evaluate(x);
+    else
+        return std::tanh(x);
 }
 
+template <bool UseTables>
 float ExciterSaturation::softSaturation(float x)
 {
     // Smooth tanh saturation
-    return std::tanh(x);
+    return saturate<UseTables>(x);
 }
 
 float ExciterSaturation::hardClip(float x)
@@ -203,19 +609,21 @@ float ExciterSaturation::hardClip(float x)
         return (x > 0.0f) ? 1.5f : -1.5f;
 }
 
+template <bool UseTables>
 float ExciterSaturation::tubeSaturation(float x)
 {
     // Asymmetric saturation (emphasizes even harmonics)
     float bias = 0.1f;
     float biased = x + bias;
-    return std::tanh(biased) - std::tanh(bias);
+    return saturate<UseTables>(biased) - std::tanh(bias);
 }
 
+template <bool UseTables>
 float ExciterSaturation::tapeSaturation(float x)
 {
     // Tape-style saturation with compression
     float compressed = x / (1.0f + std::abs(x) * 0.3f);
-    return std::tanh(compressed * 1.5f);
+    return saturate<UseTables>(compressed * 1.5f);
 }
 
 float ExciterSaturation::transformerSaturation(float x)
@@ -227,69 +635,248 @@ float ExciterSaturation::transformerSaturation(float x)
 
 float ExciterSaturation::digitalSaturation(float x)
 {
-    // Bit reduction style
-    float bits = 8.0f;
-    float levels = std::pow(2.0f, bits);
+    // Bit reduction style, 8 bits
+    constexpr float levels = 256.0f;
     return std::round(x * levels) / levels;
 }
 
-float ExciterSaturation::waveshape(float x, SaturationType type)
+template <ExciterSaturation::SaturationType Type, bool UseTables>
+float ExciterSaturation::waveshape(float x)
 {
-    // Map drive (0-1) to useful range (1-20)
-    float driveAmount = juce::jmap(smoothedDrive.getNextValue(), 1.0f, 20.0f);
-    float driven = x * driveAmount;
+    if constexpr (Type == SaturationType::Soft)
+        return softSaturation<UseTables>(x);
+    else if constexpr (Type == SaturationType::Hard)
+        return hardClip(x);
+    else if constexpr (Type == SaturationType::Tube)
+        return tubeSaturation<UseTables>(x);
+    else if constexpr (Type == SaturationType::Tape)
+        return tapeSaturation<UseTables>(x);
+    else if constexpr (Type == SaturationType::Transformer)
+        return transformerSaturation(x);
+    else
+        return digitalSaturation(x);
+}
+
+template <ExciterSaturation::HarmonicMode Mode, bool UseTables>
+float ExciterSaturation::applyHarmonicMode(float x)
+{
+    if constexpr (Mode == HarmonicMode::OddOnly)
+    {
+        // Symmetric saturation emphasizes odd harmonics
+        return saturate<UseTables>(x * 2.0f) * 0.5f;
+    }
+    else if constexpr (Mode == HarmonicMode::EvenOnly)
+    {
+        // Asymmetric saturation emphasizes even harmonics
+        float rectified = std::abs(x);
+        float shaped = saturate<UseTables>(rectified * 1.5f);
+        return (x >= 0.0f) ? shaped : -shaped * 0.8f;
+    }
+    else
+    {
+        return x;
+    }
+}
 
-    float output = 0.0f;
+template <ExciterSaturation::Antialiasing Order, typename Shape>
+double ExciterSaturation::antialias(double x, AntialiasState& state)
+{
+    if constexpr (Order == Antialiasing::FirstOrder)
+    {
+        // y = (F1(x) - F1(x1)) / (x - x1)
+        const double antiderivative = Shape::F1(x);
+        const double step = x - state.x1;
+        const double y = std::abs(step) < antialiasTolerance
+            ? Shape::f(0.5 * (x + state.x1))
+            : (antiderivative - state.antiderivative) / step;
+
+        state.x1 = x;
+        state.antiderivative = antiderivative;
+        return y;
+    }
+    else
+    {
+        // y = 2 / (x - x2) * (D(x, x1) - D(x1, x2)), D(a, b) = (F2(a) - F2(b)) / (a - b)
+        const double antiderivative = Shape::F2(x);
+        const double step = x - state.x1;
+        const double difference = std::abs(step) < antialiasTolerance
+            ? Shape::F1(0.5 * (x + state.x1))
+            : (antiderivative - state.antiderivative) / step;
 
-    switch (type)
+        const double span = x - state.x2;
+        double y;
+
+        if (std::abs(span) >= antialiasTolerance)
+        {
+            y = 2.0 * (difference - state.difference) / span;
+        }
+        else
+        {
+            // x and x2 coincide: expand around their mean instead
+            const double mean = 0.5 * (x + state.x2);
+            const double delta = mean - state.x1;
+
+            y = std::abs(delta) < antialiasTolerance
+                ? Shape::f(0.5 * (mean + state.x1))
+                : 2.0 / delta * (Shape::F1(mean) + (state.antiderivative - Shape::F2(mean)) / delta);
+        }
+
+        state.x2 = state.x1;
+        state.x1 = x;
+        state.antiderivative = antiderivative;
+        state.difference = difference;
+        return y;
+    }
+}
+
+template <ExciterSaturation::Antialiasing Order, ExciterSaturation::SaturationType Type>
+double ExciterSaturation::antialiasedWaveshape(double x, AntialiasState& state)
+{
+    if constexpr (Type == SaturationType::Soft)
+    {
+        return antialias<Order, TanhShape>(x, state);
+    }
+    else if constexpr (Type == SaturationType::Tube)
+    {
+        // The bias is a constant shift, so only the tanh needs antialiasing
+        constexpr double bias = 0.1;
+        return antialias<Order, TanhShape>(x + bias, state) - std::tanh(bias);
+    }
+    else if constexpr (Type == SaturationType::Tape)
+    {
+        // The compression curve has no closed-form antiderivative once inside
+        // the tanh; it is smooth and bounded, so it is applied directly and
+        // only the tanh stage is antialiased
+        const double compressed = x / (1.0 + std::abs(x) * 0.3);
+        return antialias<Order, TanhShape>(compressed * 1.5, state);
+    }
+    else
+    {
+        static_assert(Type == SaturationType::Transformer, "No antiderivatives for this shape");
+        return antialias<Order, CubicShape>(x, state);
+    }
+}
+
+template <bool UseTables, ExciterSaturation::Antialiasing Order, ExciterSaturation::SaturationType Type,
+    ExciterSaturation::HarmonicMode Mode>
+void ExciterSaturation::shapeBlock(float* samples, const float* drive, int numSamples,
+    [[maybe_unused]] AntialiasState& state, const float*)
+{
+    constexpr bool useAntialiasing = Order != Antialiasing::Off
+        && Type != SaturationType::Hard && Type != SaturationType::Digital;
+
+    for (int i = 0; i < numSamples; ++i)
     {
-    case SaturationType::Soft:
-        output = softSaturation(driven);
-        break;
-    case SaturationType::Hard:
-        output = hardClip(driven);
-        break;
-    case SaturationType::Tube:
-        output = tubeSaturation(driven);
-        break;
-    case SaturationType::Tape:
-        output = tapeSaturation(driven);
-        break;
-    case SaturationType::Transformer:
-        output = transformerSaturation(driven);
-        break;
-    case SaturationType::Digital:
-        output = digitalSaturation(driven);
-        break;
+        // Drive into the shaper, then normalize output
+        const float driveAmount = drive[i];
+        float shaped;
+
+        if constexpr (useAntialiasing)
+            shaped = static_cast<float>(antialiasedWaveshape<Order, Type>(samples[i] * driveAmount, state));
+        else
+            shaped = waveshape<Type, UseTables>(samples[i] * driveAmount);
+
+        samples[i] = applyHarmonicMode<Mode, UseTables>(shaped / driveAmount);
     }
 
-    // Normalize output
-    return output / driveAmount;
+    if constexpr (Order != Antialiasing::Off && ! useAntialiasing)
+        matchAntialiasingDelay<Order>(samples, numSamples, state);
 }
 
-float ExciterSaturation::applyHarmonicMode(float x, HarmonicMode mode)
+template <ExciterSaturation::Antialiasing Order>
+void ExciterSaturation::generateHarmonics(float* samples, const float* drive, int numSamples,
+    [[maybe_unused]] AntialiasState& state, const float* polynomial)
 {
-    switch (mode)
+    // x + amount * H(x), H the gain-weighted T2..T8 sum in power form. Drive
+    // (1-20) sets the amount. Only H's argument is clamped to the polynomials'
+    // domain; the input itself passes through untouched, so a hot signal
+    // isn't hard-clipped. No transcendental calls, so the loop vectorises
+    constexpr float driveToAmount = 1.0f / 19.0f;
+
+    for (int i = 0; i < numSamples; ++i)
     {
-    case HarmonicMode::Balanced:
-        return x;
+        const float x = juce::jlimit(-1.0f, 1.0f, samples[i]);
 
-    case HarmonicMode::OddOnly:
+        float harmonics = polynomial[maxChebyshevOrder];
+        for (int k = maxChebyshevOrder - 1; k >= 0; --k)
+            harmonics = harmonics * x + polynomial[k];
+
+        samples[i] += (drive[i] - 1.0f) * driveToAmount * harmonics;
+    }
+
+    if constexpr (Order != Antialiasing::Off)
+        matchAntialiasingDelay<Order>(samples, numSamples, state);
+}
+
+template <ExciterSaturation::Antialiasing Order>
+void ExciterSaturation::matchAntialiasingDelay(float* samples, int numSamples, AntialiasState& state)
+{
+    // On a straight line first-order ADAA is (y + y1) / 2 and second-order
+    // (y + y1 + y2) / 3, so these shapes get the same half- or one-sample
+    // delay as the antialiased ones. The history reuses x1 and x2
+    for (int i = 0; i < numSamples; ++i)
     {
-        // Symmetric saturation emphasizes odd harmonics
-        return std::tanh(x * 2.0f) * 0.5f;
+        const double y = samples[i];
+
+        if constexpr (Order == Antialiasing::FirstOrder)
+        {
+            samples[i] = static_cast<float>(0.5 * (y + state.x1));
+        }
+        else
+        {
+            samples[i] = static_cast<float>((y + state.x1 + state.x2) / 3.0);
+            state.x2 = state.x1;
+        }
+
+        state.x1 = y;
     }
+}
+
+template <bool UseTables, ExciterSaturation::Antialiasing Order, ExciterSaturation::SaturationType Type>
+constexpr ExciterSaturation::ShapeKernelRow ExciterSaturation::makeKernelRow()
+{
+    return { &shapeBlock<UseTables, Order, Type, HarmonicMode::Balanced>,
+             &shapeBlock<UseTables, Order, Type, HarmonicMode::OddOnly>,
+             &shapeBlock<UseTables, Order, Type, HarmonicMode::EvenOnly>,
+             &generateHarmonics<Order> };
+}
+
+template <bool UseTables, ExciterSaturation::Antialiasing Order>
+constexpr ExciterSaturation::ShapeKernelTable ExciterSaturation::makeKernelTable()
+{
+    return { makeKernelRow<UseTables, Order, SaturationType::Soft>(),
+             makeKernelRow<UseTables, Order, SaturationType::Hard>(),
+             makeKernelRow<UseTables, Order, SaturationType::Tube>(),
+             makeKernelRow<UseTables, Order, SaturationType::Tape>(),
+             makeKernelRow<UseTables, Order, SaturationType::Transformer>(),
+             makeKernelRow<UseTables, Order, SaturationType::Digital>() };
+}
+
+const std::array<std::array<ExciterSaturation::ShapeKernelTable, ExciterSaturation::numAntialiasingModes>, 2>
+    ExciterSaturation::shapeKernels = { { { makeKernelTable<false, Antialiasing::Off>(),
+                                            makeKernelTable<false, Antialiasing::FirstOrder>(),
+                                            makeKernelTable<false, Antialiasing::SecondOrder>() },
+                                          { makeKernelTable<true, Antialiasing::Off>(),
+                                            makeKernelTable<true, Antialiasing::FirstOrder>(),
+                                            makeKernelTable<true, Antialiasing::SecondOrder>() } } };
+
+void ExciterSaturation::renderDriveRamp(juce::SmoothedValue<float>& smoother, int numSamples)
+{
+    // Map drive (0-1) to useful range (1-20)
+    auto* ramp = driveRamp.data();
 
-    case HarmonicMode::EvenOnly:
+    if (smoother.isSmoothing())
     {
-        // Asymmetric saturation emphasizes even harmonics
-        float rectified = std::abs(x);
-        float shaped = std::tanh(rectified * 1.5f);
-        return (x >= 0.0f) ? shaped : -shaped * 0.8f;
+        for (int i = 0; i < numSamples; ++i)
+            ramp[i] = smoother.getNextValue();
     }
+    else
+    {
+        juce::FloatVectorOperations::fill(ramp, smoother.getTargetValue(), numSamples);
     }
 
-    return x;
+    juce::FloatVectorOperations::multiply(ramp, 19.0f, numSamples);
+    juce::FloatVectorOperations::add(ramp, 1.0f, numSamples);
 }
 
 void ExciterSaturation::process(juce::dsp::AudioBlock<float>& block)
@@ -300,47 +887,202 @@ void ExciterSaturation::process(juce::dsp::AudioBlock<float>& block)
     auto numSamples = static_cast<int>(block.getNumSamples());
     auto numChannels = static_cast<int>(block.getNumChannels());
 
-    // Store dry signal
-    dryBuffer.clear();
-    for (int ch = 0; ch < numChannels; ++ch)
-        dryBuffer.copyFrom(ch, 0, block.getChannelPointer(static_cast<size_t>(ch)), numSamples);
+    // An oversampling or band change waits until the wet path has ducked out
+    const bool pendingChange = hasPendingChange();
+    if (pendingChange)
+    {
+        if (switchGain.getCurrentValue() <= 0.0f)
+        {
+            const float oldLatency = dryDelay.getDelay();
+            applyPendingChange();
+            switchGain.setTargetValue(1.0f);
+
+            if (dryDelay.getDelay() != oldLatency)
+                previousDryLatency = oldLatency;
+        }
+        else
+        {
+            switchGain.setTargetValue(0.0f);
+        }
+    }
+    else
+    {
+        // A change undone before it was applied brings the wet straight back
+        switchGain.setTargetValue(1.0f);
+    }
+
+    // The duck is rendered once for the wet gain and the dry's latency fade
+    switching = pendingChange || switchGain.isSmoothing() || switchGain.getCurrentValue() < 1.0f;
+    if (switching)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            switchRamp[static_cast<size_t>(i)] = switchGain.getNextValue();
+    }
+    else
+    {
+        previousDryLatency = -1.0f;
+    }
+
+    // The block is the dry signal: the wet path renders beside it and is
+    // mixed back at the end. A fully dry setting skips the effect, a fully
+    // wet one renders straight into the block
+    const bool mixSettled = ! smoothedMix.isSmoothing();
+    const float mixTarget = smoothedMix.getTargetValue();
 
-    // Calculate input RMS for auto-gain
-    if (autoGainEnabled)
+    const bool needsDry = ! mixSettled || mixTarget < 1.0f || autoGainEnabled;
+
+    // Resuming the dry path: flush what the delay held when it last ran
+    if (needsDry && ! dryPathActive)
+        dryDelay.reset();
+    dryPathActive = needsDry;
+
+    if (mixSettled && mixTarget <= 0.0f)
+    {
+        delayDry(block);
+    }
+    else
     {
-        for (int ch = 0; ch < juce::jmin(numChannels, 2); ++ch)
+        auto wet = needsDry
+            ? juce::dsp::AudioBlock<float>(wetBuffer).getSubsetChannelBlock(0, static_cast<size_t>(numChannels))
+                  .getSubBlock(0, static_cast<size_t>(numSamples))
+            : block;
+
+        if (numBands > 1)
+            processBands(block, wet);
+        else
+            processFullBand(block, wet);
+
+        // Apply tone filter (at normal sample rate)
+        juce::dsp::ProcessContextReplacing<float> context(wet);
+        toneFilter.process(context);
+
+        if (needsDry)
         {
-            float rms = 0.0f;
-            auto* samples = block.getChannelPointer(static_cast<size_t>(ch));
-            for (int i = 0; i < numSamples; ++i)
-                rms += samples[i] * samples[i];
-            inputRMS[static_cast<size_t>(ch)] = std::sqrt(rms / static_cast<float>(numSamples));
+            mixWithDry(block, wet);
+        }
+        else if (switching)
+        {
+            // Fully wet: there is no dry to keep running
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::multiply(block.getChannelPointer(static_cast<size_t>(ch)),
+                    switchRamp.data(), numSamples);
         }
     }
 
-    // Upsample
-    juce::dsp::AudioBlock<float> oversampledBlock = oversampling.processSamplesUp(block);
+}
 
-    // Apply highpass filter
-    highpass.process(juce::dsp::ProcessContextReplacing<float>(oversampledBlock));
+void ExciterSaturation::delayDry(juce::dsp::AudioBlock<float>& block)
+{
+    // At zero latency the delay still runs through a switch, so it has the
+    // history a new latency will read
+    const float latency = dryDelay.getDelay();
+    if (latency <= 0.0f && ! switching)
+        return;
 
-    // Apply pre-emphasis
-    preEmphasis.process(juce::dsp::ProcessContextReplacing<float>(oversampledBlock));
+    for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        auto* samples = block.getChannelPointer(ch);
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+        {
+            dryDelay.pushSample(static_cast<int>(ch), samples[i]);
+
+            if (previousDryLatency >= 0.0f)
+            {
+                // Fade from the old delay to the new one as the wet returns
+                const float previous = dryDelay.popSample(static_cast<int>(ch), previousDryLatency, false);
+                const float current = dryDelay.popSample(static_cast<int>(ch), latency);
+                samples[i] = previous + switchRamp[i] * (current - previous);
+            }
+            else
+            {
+                samples[i] = dryDelay.popSample(static_cast<int>(ch));
+            }
+        }
+    }
+}
 
-    // Apply saturation
-    for (int ch = 0; ch < numChannels; ++ch)
+void ExciterSaturation::mixWithDry(juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<float>& wet)
+{
+    // The oversamplers are stereo, so at most two channels reach here
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+    const auto numChannels = static_cast<int>(block.getNumChannels());
+    jassert(numChannels <= 2);
+
+    // The dry is read from the block and delayed on the fly to line up with
+    // the wet path's latency
+    delayDry(block);
+
+    auto* outL = block.getChannelPointer(0);
+    auto* outR = numChannels > 1 ? block.getChannelPointer(1) : outL;
+    const auto* wetL = wet.getChannelPointer(0);
+    const auto* wetR = numChannels > 1 ? wet.getChannelPointer(1) : wetL;
+
+    // Equal-power crossfade, recomputed per sample only while the mix moves
+    float wetGain = std::sin(smoothedMix.getCurrentValue() * juce::MathConstants<float>::halfPi);
+    float dryGain = std::cos(smoothedMix.getCurrentValue() * juce::MathConstants<float>::halfPi);
+    const bool mixSmoothing = smoothedMix.isSmoothing();
+
+    for (int i = 0; i < numSamples; ++i)
     {
-        auto* samples = oversampledBlock.getChannelPointer(static_cast<size_t>(ch));
-        auto oversampledNumSamples = static_cast<int>(oversampledBlock.getNumSamples());
+        if (mixSmoothing)
+        {
+            const float currentMix = smoothedMix.getNextValue();
+            wetGain = std::sin(currentMix * juce::MathConstants<float>::halfPi);
+            dryGain = std::cos(currentMix * juce::MathConstants<float>::halfPi);
+        }
+
+        const float wl = wetL[i], wr = wetR[i];
+        const float dl = outL[i], dr = outR[i];
+        float gain = wetGain;
 
-        for (int i = 0; i < oversampledNumSamples; ++i)
+        if (autoGainEnabled)
         {
-            float input = samples[i];
-            float shaped = waveshape(input, saturationType);
-            shaped = applyHarmonicMode(shaped, harmonicMode);
-            samples[i] = shaped;
+            // Mean-square envelopes; a mono block counts its channel twice
+            // on both sides, so the ratio is unaffected
+            inputEnvelope += envelopeCoeff * (dl * dl + dr * dr - inputEnvelope);
+            outputEnvelope += envelopeCoeff * (wl * wl + wr * wr - outputEnvelope);
+
+            if (outputEnvelope > 1.0e-8f)
+                gain *= juce::jlimit(0.5f, 2.0f, std::sqrt(inputEnvelope / outputEnvelope));  // Limit to 6dB
         }
+
+        if (switching)
+            gain *= switchRamp[static_cast<size_t>(i)];
+
+        outL[i] = wl * gain + dl * dryGain;
+        outR[i] = wr * gain + dr * dryGain;
     }
+}
+
+void ExciterSaturation::processFullBand(const juce::dsp::AudioBlock<float>& input, juce::dsp::AudioBlock<float>& wet)
+{
+    const auto numChannels = static_cast<int>(input.getNumChannels());
+
+    // Upsample straight from the input; at 1x the wet path shapes in place,
+    // so it needs the input in its own buffer first
+    auto* oversampler = getOversampler(oversamplingStages, oversamplingFilter);
+    if (oversampler == nullptr && wet.getChannelPointer(0) != input.getChannelPointer(0))
+        wet.copyFrom(input);
+
+    juce::dsp::AudioBlock<float> oversampledBlock = oversampler != nullptr
+        ? oversampler->processSamplesUp(input)
+        : wet;
+
+    // Apply highpass filter
+    highpass.process(juce::dsp::ProcessContextReplacing<float>(oversampledBlock));
+
+    // Apply pre-emphasis
+    preEmphasis.process(juce::dsp::ProcessContextReplacing<float>(oversampledBlock));
+
+    // Apply saturation: one drive ramp for every channel, one kernel per block
+    auto oversampledNumSamples = static_cast<int>(oversampledBlock.getNumSamples());
+    renderDriveRamp(smoothedDrive, oversampledNumSamples);
+
+    const auto kernel = shapeKernels[lookupTablesEnabled ? 1 : 0][static_cast<size_t>(antialiasing)]
+        [static_cast<size_t>(saturationType)][static_cast<size_t>(harmonicMode)];
+    for (int ch = 0; ch < numChannels; ++ch)
+        kernel(oversampledBlock.getChannelPointer(static_cast<size_t>(ch)), driveRamp.data(),
+            oversampledNumSamples, antialiasStates[static_cast<size_t>(ch)], chebyshevPolynomial.data());
 
     // Apply de-emphasis
     deEmphasis.process(juce::dsp::ProcessContextReplacing<float>(oversampledBlock));
@@ -349,49 +1091,151 @@ void ExciterSaturation::process(juce::dsp::AudioBlock<float>& block)
     dcBlocker.process(juce::dsp::ProcessContextReplacing<float>(oversampledBlock));
 
     // Downsample
-    oversampling.processSamplesDown(block);
+    if (oversampler != nullptr)
+        oversampler->processSamplesDown(wet);
+}
 
-    // Apply tone filter (at normal sample rate)
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    toneFilter.process(context);
+void ExciterSaturation::processBands(const juce::dsp::AudioBlock<float>& input, juce::dsp::AudioBlock<float>& wet)
+{
+    const auto numSamples = static_cast<int>(input.getNumSamples());
+    const auto numChannels = static_cast<int>(input.getNumChannels());
 
-    // Calculate output RMS and apply auto-gain
-    float gainComp = 1.0f;
-    if (autoGainEnabled)
+    // Split through the crossover tree: each crossover peels the lowest band
+    // off the remainder, then the lower bands pick up the allpass phase of
+    // every crossover above them
+    for (int ch = 0; ch < numChannels; ++ch)
     {
-        for (int ch = 0; ch < juce::jmin(numChannels, 2); ++ch)
+        const auto* in = input.getChannelPointer(static_cast<size_t>(ch));
+        std::array<float*, maxBands> outputs {};
+        for (int band = 0; band < numBands; ++band)
+            outputs[static_cast<size_t>(band)] = bands[static_cast<size_t>(band)].buffer.getWritePointer(ch);
+
+        for (int i = 0; i < numSamples; ++i)
         {
-            float rms = 0.0f;
-            auto* samples = block.getChannelPointer(static_cast<size_t>(ch));
-            for (int i = 0; i < numSamples; ++i)
-                rms += samples[i] * samples[i];
-            outputRMS[static_cast<size_t>(ch)] = std::sqrt(rms / static_cast<float>(numSamples));
+            float remainder = in[i];
+
+            for (int k = 0; k < numBands - 1; ++k)
+            {
+                float low = 0.0f, high = 0.0f;
+                crossovers[static_cast<size_t>(k)].processSample(ch, remainder, low, high);
+                outputs[static_cast<size_t>(k)][i] = low;
+                remainder = high;
+            }
+
+            outputs[static_cast<size_t>(numBands - 1)][i] = remainder;
+
+            for (int j = 0; j < numBands - 2; ++j)
+                for (int k = j + 1; k < numBands - 1; ++k)
+                    outputs[static_cast<size_t>(j)][i] = crossoverAllpasses[static_cast<size_t>(j + k - 1)]
+                        .processSample(ch, outputs[static_cast<size_t>(j)][i]);
         }
+    }
+
+    // Shape each band, then sum them back into the block
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto bandBlock = juce::dsp::AudioBlock<float>(bands[static_cast<size_t>(band)].buffer)
+            .getSubsetChannelBlock(0, static_cast<size_t>(numChannels))
+            .getSubBlock(0, static_cast<size_t>(numSamples));
+
+        shapeBand(band, bandBlock);
 
-        gainComp = calculateGainCompensation();
+        if (band == 0)
+            wet.copyFrom(bandBlock);
+        else
+            wet.add(bandBlock);
     }
 
-    // Apply gain compensation and mix with dry signal (equal-power crossfade)
-    float currentMix = smoothedMix.getCurrentValue();
-    float wetGain = std::sin(currentMix * juce::MathConstants<float>::halfPi) * gainComp;
-    float dryGain = std::cos(currentMix * juce::MathConstants<float>::halfPi);
+    bandDcBlocker.process(juce::dsp::ProcessContextReplacing<float>(wet));
+}
+
+void ExciterSaturation::shapeBand(int band, juce::dsp::AudioBlock<float>& bandBlock)
+{
+    auto& b = bands[static_cast<size_t>(band)];
+    const auto numSamples = static_cast<int>(bandBlock.getNumSamples());
+    const auto numChannels = static_cast<int>(bandBlock.getNumChannels());
 
+    // The band's own dry signal, for its mix
     for (int ch = 0; ch < numChannels; ++ch)
+        bandDryBuffer.copyFrom(ch, 0, bandBlock.getChannelPointer(static_cast<size_t>(ch)), numSamples);
+
+    // Only bands whose harmonics would reach Nyquist are oversampled
+    auto* oversampler = bandOversampled[static_cast<size_t>(band)]
+        ? getOversampler(oversamplingStages, oversamplingFilter, band)
+        : nullptr;
+
+    juce::dsp::AudioBlock<float> shapingBlock = oversampler != nullptr
+        ? oversampler->processSamplesUp(bandBlock)
+        : bandBlock;
+
+    const float rate = oversampler != nullptr ? getProcessingRate() : sampleRate;
+    if (b.processingRate != rate)
     {
-        auto* wet = block.getChannelPointer(static_cast<size_t>(ch));
-        auto* dry = dryBuffer.getReadPointer(ch);
+        b.processingRate = rate;
+        b.smoothedDrive.reset(rate, 0.02);
+        b.smoothedDrive.setCurrentAndTargetValue(b.drive);
+    }
 
-        for (int i = 0; i < numSamples; ++i)
+    const auto shapingNumSamples = static_cast<int>(shapingBlock.getNumSamples());
+    renderDriveRamp(b.smoothedDrive, shapingNumSamples);
+
+    const auto kernel = shapeKernels[lookupTablesEnabled ? 1 : 0][static_cast<size_t>(antialiasing)]
+        [static_cast<size_t>(b.saturationType)][static_cast<size_t>(harmonicMode)];
+    for (int ch = 0; ch < numChannels; ++ch)
+        kernel(shapingBlock.getChannelPointer(static_cast<size_t>(ch)), driveRamp.data(), shapingNumSamples,
+            antialiasStates[static_cast<size_t>(band * numPreparedChannels + ch)], chebyshevPolynomial.data());
+
+    if (oversampler != nullptr)
+        oversampler->processSamplesDown(bandBlock);
+
+    // The band's dry is lined up with its wet, and the mixed band with the
+    // rest of the wet path; see updateBandAlignment()
+    if (b.dryAlignment.getDelay() > 0.0f)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            wet[i] = wet[i] * wetGain + dry[i] * dryGain;
+            auto* dry = bandDryBuffer.getWritePointer(ch);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                b.dryAlignment.pushSample(ch, dry[i]);
+                dry[i] = b.dryAlignment.popSample(ch);
+            }
         }
+    }
+
+    // Band mix: dry + mix * (wet - dry), the ramp shared by every channel
+    auto* mixRamp = driveRamp.data();
+    if (b.smoothedMix.isSmoothing())
+    {
+        for (int i = 0; i < numSamples; ++i)
+            mixRamp[i] = b.smoothedMix.getNextValue();
+    }
+    else
+    {
+        juce::FloatVectorOperations::fill(mixRamp, b.smoothedMix.getTargetValue(), numSamples);
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* wet = bandBlock.getChannelPointer(static_cast<size_t>(ch));
+        const auto* dry = bandDryBuffer.getReadPointer(ch);
 
-        // Advance smoothed mix for next sample
-        smoothedMix.skip(1);
+        for (int i = 0; i < numSamples; ++i)
+            wet[i] = dry[i] + mixRamp[i] * (wet[i] - dry[i]);
     }
 
-    // Reset smoothed mix position for next block
-    smoothedMix.skip(-numSamples);
+    if (b.alignment.getDelay() > 0.0f)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* samples = bandBlock.getChannelPointer(static_cast<size_t>(ch));
+            for (int i = 0; i < numSamples; ++i)
+            {
+                b.alignment.pushSample(ch, samples[i]);
+                samples[i] = b.alignment.popSample(ch);
+            }
+        }
+    }
 }
 
 void ExciterSaturation::loadPreset(const Preset& preset)
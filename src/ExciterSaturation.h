@@ -21,7 +21,25 @@ public:
     {
         Balanced,       // Both odd and even harmonics
         OddOnly,        // Odd harmonics (hollow sound)
-        EvenOnly        // Even harmonics (warm, tube-like)
+        EvenOnly,       // Even harmonics (warm, tube-like)
+        Chebyshev       // Exact harmonics 2-8 from Chebyshev polynomials, replaces the saturation curve
+    };
+
+    // Antiderivative anti-aliasing for the Soft, Tube, Tape and Transformer
+    // shapers. Hard, Digital and Chebyshev have no antiderivatives and get the
+    // matching averaging instead, so every shape has the same delay
+    enum class Antialiasing
+    {
+        Off,
+        FirstOrder,     // Half-sample delay at the processing rate, good with 2x oversampling
+        SecondOrder     // One-sample delay at the processing rate, usable without oversampling
+    };
+
+    // Half-band filters used by the oversampler
+    enum class OversamplingFilter
+    {
+        PolyphaseIIR,   // Minimum phase, low latency
+        LinearPhaseFIR  // Linear phase, higher latency
     };
 
     // Preset structure
@@ -60,6 +78,33 @@ public:
     void setSaturationType(SaturationType type);
     void setHarmonicMode(HarmonicMode mode);
     void setAutoGainEnabled(bool enabled);
+    void setAutoGainTime(float timeMs);         // Envelope time constant, 10 to 2000 ms
+    void setAntialiasing(Antialiasing newAntialiasing);
+    void setOversamplingFactor(int newFactor);  // 1 (off), 2, 4 or 8
+    void setOversamplingFilter(OversamplingFilter newFilter);
+    void setLookupTablesEnabled(bool enabled);  // Tabulated tanh, on by default
+
+    // Chebyshev harmonic generator: level of harmonic 'order' (2 to 8) for a
+    // full-scale sine, scaled by drive
+    static constexpr int maxChebyshevOrder = 8;
+    void setChebyshevGain(int order, float gain);  // -1.0 to 1.0
+    float getChebyshevGain(int order) const;
+
+    // Smallest factor that keeps the current harmonics out of the audible band
+    int getRecommendedOversamplingFactor() const;
+
+    // Multiband mode: 2 to 4 bands split by Linkwitz-Riley crossovers, each
+    // with its own drive, type and mix. One band is the normal full-band path
+    static constexpr int maxBands = 4;
+    void setNumBands(int newNumBands);                      // 1 to maxBands
+    void setCrossoverFrequency(int index, float freqHz);    // index 0 to maxBands - 2, ascending
+    void setBandDrive(int band, float newDrive);            // 0.0 to 1.0
+    void setBandMix(int band, float newMix);                // 0.0 (band dry) to 1.0
+    void setBandSaturationType(int band, SaturationType type);
+
+    // Latency of the active oversampler plus the ADAA delay; the dry path is
+    // delayed to match
+    int getLatencySamples() const;
 
     void process(juce::dsp::AudioBlock<float>& block);
 
@@ -78,11 +123,51 @@ private:
     SaturationType saturationType = SaturationType::Soft;
     HarmonicMode harmonicMode = HarmonicMode::Balanced;
     bool autoGainEnabled = true;
+    Antialiasing antialiasing = Antialiasing::Off;
+    Antialiasing pendingAntialiasing = Antialiasing::Off;
+    bool lookupTablesEnabled = true;
+
+    // Per-order gains for T2..T8 and the same sum collapsed to a power series
+    // (constant term dropped) so it is a single Horner evaluation
+    std::array<float, maxChebyshevOrder - 1> chebyshevGains = { 0.2f, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    std::array<float, maxChebyshevOrder + 1> chebyshevPolynomial {};
+    void updateChebyshevPolynomial();
 
     float sampleRate = 44100.0f;
+    float getProcessingRate() const { return sampleRate * static_cast<float>(1 << oversamplingStages); }
+
+    // 2x, 4x and 8x oversamplers for each filter type, all initialised in
+    // prepare() so a change of factor only swaps which one is used
+    static constexpr int maxOversamplingStages = 3;
+    // Slot 0 serves the full-band path, slot n band n in multiband mode
+    std::array<std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, 2 * maxOversamplingStages>,
+        maxBands> oversamplers;
+    juce::dsp::Oversampling<float>* getOversampler(int stages, OversamplingFilter filter, int slot = 0) const;
+
+    int oversamplingStages = 1;         // log2 of the active factor
+    OversamplingFilter oversamplingFilter = OversamplingFilter::PolyphaseIIR;
+    int pendingOversamplingStages = 1;
+    OversamplingFilter pendingOversamplingFilter = OversamplingFilter::PolyphaseIIR;
+
+    // The wet path is ducked out around an oversampling, antialiasing or
+    // band-count change, since its filter states and latency both jump. The dry keeps
+    // running and crossfades to its new delay as the wet comes back in
+    juce::SmoothedValue<float> switchGain;
+    std::vector<float> switchRamp;              // switchGain per sample for the current block
+    bool switching = false;
+    float previousDryLatency = -1.0f;           // Dry delay being faded out, or -1
+    bool hasPendingChange() const;
+    void applyPendingChange();
+
+    // Keeps the dry signal aligned with the wet path. Linear interpolation
+    // only ever reads between samples for first-order ADAA at 1x, where it is
+    // the same two-point average the ADAA applies to the wet
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> dryDelay;
 
-    // 2x oversampling
-    juce::dsp::Oversampling<float> oversampling;
+    // Wet path delay in base-rate samples: the oversampler latency plus the
+    // ADAA delay, rounded when oversampled as the oversampler latency is
+    float getWetLatency() const;
+    float getAntialiasingDelay() const;         // At the processing rate
 
     // Pre-saturation highpass
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
@@ -105,37 +190,142 @@ private:
         juce::dsp::IIR::Coefficients<float>> toneFilter;
 
     // Smoothed parameters to avoid zipper noise
-    juce::SmoothedValue<float> smoothedDrive;
+    juce::SmoothedValue<float> smoothedDrive;   // Runs at the oversampled rate
     juce::SmoothedValue<float> smoothedMix;
 
+    // Multiband state. Band j is phase-aligned with the bands above it by
+    // allpasses at every higher crossover, so the bands sum flat
+    struct Band
+    {
+        float drive = 0.5f;
+        float mix = 1.0f;
+        SaturationType saturationType = SaturationType::Soft;
+        juce::SmoothedValue<float> smoothedDrive;   // At the band's processing rate
+        juce::SmoothedValue<float> smoothedMix;
+        float processingRate = 0.0f;
+        juce::AudioBuffer<float> buffer;
+        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> dryAlignment;    // Band dry, to the band's wet
+        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> alignment;       // Mixed band, to the wet path
+    };
+
+    int numBands = 1;
+    int pendingNumBands = 1;
+    std::array<Band, maxBands> bands;
+    std::array<float, maxBands - 1> crossoverFrequencies = { 200.0f, 2000.0f, 8000.0f };
+    std::array<float, maxBands - 1> activeCrossovers = crossoverFrequencies;  // Sorted, for the active bands
+    std::array<bool, maxBands> bandOversampled {};
+    std::array<juce::dsp::LinkwitzRileyFilter<float>, maxBands - 1> crossovers;
+    std::array<juce::dsp::LinkwitzRileyFilter<float>, 3> crossoverAllpasses;    // (band, crossover): (0,1) (0,2) (1,2)
+    juce::AudioBuffer<float> bandDryBuffer;
+    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
+        juce::dsp::IIR::Coefficients<float>> bandDcBlocker;     // At the base rate, after the bands are summed
+
+    void updateCrossovers();
+    void updateBandAlignment();
+    bool bandNeedsOversampling(int band) const;
+    void processFullBand(const juce::dsp::AudioBlock<float>& input, juce::dsp::AudioBlock<float>& wet);
+    void processBands(const juce::dsp::AudioBlock<float>& input, juce::dsp::AudioBlock<float>& wet);
+    void shapeBand(int band, juce::dsp::AudioBlock<float>& bandBlock);
+
     // Buffers
-    juce::AudioBuffer<float> dryBuffer;
+    juce::AudioBuffer<float> wetBuffer;         // Wet path while the block itself still holds the dry
     juce::AudioBuffer<float> oversampledBuffer;
+    std::vector<float> driveRamp;               // Drive gain per oversampled sample, shared by all channels
+
+    // Per-channel ADAA history, kept in the domain the antiderivatives are
+    // evaluated in (after drive and any pre-warping)
+    struct AntialiasState
+    {
+        double x1 = 0.0;        // Previous input
+        double x2 = 0.0;        // Input before that (second order)
+        double antiderivative = 0.0;    // F1(x1) for first order, F2(x1) for second
+        double difference = 0.0;        // Previous divided difference (second order)
+    };
+    std::vector<AntialiasState> antialiasStates;    // [slot][channel], slots as for oversamplers
+    int numPreparedChannels = 2;
 
-    // RMS metering for auto-gain
-    std::array<float, 2> inputRMS = { 0.0f, 0.0f };
-    std::array<float, 2> outputRMS = { 0.0f, 0.0f };
+    // Auto-gain: one-pole mean-square envelopes of the dry and wet signals,
+    // stereo-linked and updated per sample inside the mix pass
+    float autoGainTimeMs = 300.0f;
+    float envelopeCoeff = 0.0f;
+    float inputEnvelope = 0.0f;
+    float outputEnvelope = 0.0f;
 
-    // Waveshaping functions
-    float waveshape(float x, SaturationType type);
-    float softSaturation(float x);
-    float hardClip(float x);
-    float tubeSaturation(float x);
-    float tapeSaturation(float x);
-    float transformerSaturation(float x);
-    float digitalSaturation(float x);
+    // Waveshaping functions; UseTables swaps std::tanh for WaveshaperTables::Tanh
+    template <bool UseTables>
+    static float saturate(float x);
+
+    template <bool UseTables>
+    static float softSaturation(float x);
+    static float hardClip(float x);
+    template <bool UseTables>
+    static float tubeSaturation(float x);
+    template <bool UseTables>
+    static float tapeSaturation(float x);
+    static float transformerSaturation(float x);
+    static float digitalSaturation(float x);
+
+    template <SaturationType Type, bool UseTables>
+    static float waveshape(float x);
 
     // Harmonic filtering
-    float applyHarmonicMode(float x, HarmonicMode mode);
+    template <HarmonicMode Mode, bool UseTables>
+    static float applyHarmonicMode(float x);
+
+    // ADAA evaluation of a shape with closed-form antiderivatives
+    template <Antialiasing Order, typename Shape>
+    static double antialias(double x, AntialiasState& state);
+
+    template <Antialiasing Order, SaturationType Type>
+    static double antialiasedWaveshape(double x, AntialiasState& state);
+
+    // Block kernels, one per (tables, Antialiasing, SaturationType,
+    // HarmonicMode) combination, picked once per block so the per-sample
+    // loop has no switches
+    static constexpr int numAntialiasingModes = 3;
+    static constexpr int numSaturationTypes = 6;
+    static constexpr int numHarmonicModes = 4;
+
+    using ShapeKernel = void (*)(float* samples, const float* drive, int numSamples,
+        AntialiasState& state, const float* polynomial);
+    using ShapeKernelRow = std::array<ShapeKernel, numHarmonicModes>;
+    using ShapeKernelTable = std::array<ShapeKernelRow, numSaturationTypes>;
+
+    template <bool UseTables, Antialiasing Order, SaturationType Type, HarmonicMode Mode>
+    static void shapeBlock(float* samples, const float* drive, int numSamples,
+        AntialiasState& state, const float* polynomial);
+
+    // Chebyshev mode, shared by every type
+    template <Antialiasing Order>
+    static void generateHarmonics(float* samples, const float* drive, int numSamples,
+        AntialiasState& state, const float* polynomial);
+
+    // The averaging ADAA reduces to on a straight line, for the shapes
+    // without antiderivatives
+    template <Antialiasing Order>
+    static void matchAntialiasingDelay(float* samples, int numSamples, AntialiasState& state);
+
+    template <bool UseTables, Antialiasing Order, SaturationType Type>
+    static constexpr ShapeKernelRow makeKernelRow();
+
+    template <bool UseTables, Antialiasing Order>
+    static constexpr ShapeKernelTable makeKernelTable();
+
+    static const std::array<std::array<ShapeKernelTable, numAntialiasingModes>, 2> shapeKernels;
+
+    void renderDriveRamp(juce::SmoothedValue<float>& smoother, int numSamples);
 
-    // Gain compensation
-    float calculateGainCompensation();
+    void updateEnvelopeCoeff();
+    void mixWithDry(juce::dsp::AudioBlock<float>& block, const juce::dsp::AudioBlock<float>& wet);
+    void delayDry(juce::dsp::AudioBlock<float>& block);
+    bool dryPathActive = true;
 
     // Filter update helpers
     void updateHighpass();
     void updatePreEmphasis();
     void updateDeEmphasis();
     void updateToneFilter();
+    void updateDcBlocker();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ExciterSaturation)
 };
\ No newline at end of file
@@ -0,0 +1,468 @@
+#include "FdnReverb.h"
+
+namespace
+{
+    // Nominal line lengths, spread so no two share a low-order ratio; each is
+    // rounded up to a prime number of samples at the running sample rate
+    constexpr std::array<float, FdnReverb::numLines> lineLengthsMs = {
+        22.1f, 26.3f, 29.9f, 33.7f, 37.9f, 41.3f, 46.1f, 51.7f
+    };
+
+    // Diffusion stages, shortest first: line l of a stage is delayed by
+    // (order[l] + 1) / numLines of the stage's span
+    constexpr std::array<float, 3> diffusionSpansMs = { 4.3f, 8.9f, 17.3f };
+    constexpr std::array<int, FdnReverb::numLines> diffusionOrder = { 3, 6, 1, 4, 7, 0, 5, 2 };
+    constexpr std::array<std::array<float, FdnReverb::numLines>, 3> diffusionFlips = { {
+        { 1, -1, 1, 1, -1, 1, -1, -1 },
+        { -1, 1, 1, -1, 1, 1, -1, 1 },
+        { 1, 1, -1, 1, -1, -1, 1, -1 }
+    } };
+
+    // The two channels drive orthogonal rows of the Hadamard matrix
+    constexpr std::array<float, FdnReverb::numLines> injectLeft = { 1, 1, 1, 1, -1, -1, -1, -1 };
+    constexpr std::array<float, FdnReverb::numLines> injectRight = { 1, -1, -1, 1, 1, -1, -1, 1 };
+
+    // Room size maps to the same decay as juce::dsp::Reverb: its comb
+    // feedback of 0.7 to 0.98 applied once per reference comb length
+    constexpr float referenceLengthSeconds = 0.032f;
+
+    constexpr float maxModulationMs = 0.5f;
+    constexpr float inputScale = 0.112f;        // Matches the wet level of juce::dsp::Reverb
+    constexpr float wetScale = 3.0f;            // Same level scaling as juce::dsp::Reverb
+    constexpr float dryScale = 2.0f;
+
+    // Copies n samples out of a ring starting at start, in at most two spans
+    void readRing(const float* ringData, int size, int start, float* dest, int n, float gain)
+    {
+        const int first = juce::jmin(n, size - start);
+        juce::FloatVectorOperations::copyWithMultiply(dest, ringData + start, gain, first);
+        juce::FloatVectorOperations::copyWithMultiply(dest + first, ringData, gain, n - first);
+    }
+
+    void writeRing(float* ringData, int size, int start, const float* source, int n)
+    {
+        const int first = juce::jmin(n, size - start);
+        std::copy(source, source + first, ringData + start);
+        std::copy(source + first, source + n, ringData);
+    }
+}
+
+FdnReverb::FdnReverb()
+{
+    params.roomSize = 0.5f;
+    params.damping = 0.5f;
+    params.wetLevel = 0.33f;
+    params.dryLevel = 0.4f;
+    params.width = 1.0f;
+    params.freezeMode = 0.0f;
+}
+
+void FdnReverb::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels <= 2);
+    sampleRate = spec.sampleRate;
+
+    int longest = 0;
+    for (size_t l = 0; l < lines; ++l)
+    {
+        lineLength[l] = nextPrime(juce::roundToInt(lineLengthsMs[l] * 0.001 * sampleRate));
+        longest = juce::jmax(longest, lineLength[l]);
+
+        // Slow, unrelated LFO rates so the lines never modulate in step
+        const double rate = 0.3 + 0.11 * static_cast<double>(l);
+        const double increment = juce::MathConstants<double>::twoPi * rate / sampleRate;
+        lfoChunkSin[l] = static_cast<float>(std::sin(increment * controlInterval));
+        lfoChunkCos[l] = static_cast<float>(std::cos(increment * controlInterval));
+    }
+
+    // A chunk must not reach into its own writes, even at full modulation
+    const int maxModulation = static_cast<int>(std::ceil(maxModulationMs * 0.001 * sampleRate));
+    jassert(*std::min_element(lineLength.begin(), lineLength.end()) - maxModulation - 1 >= controlInterval);
+
+    ringSize = longest + maxModulation + controlInterval + 2;
+    ring.assign(lines * static_cast<size_t>(ringSize), 0.0f);
+
+    int longestDiffusion = 0;
+    for (size_t stage = 0; stage < numDiffusionStages; ++stage)
+    {
+        for (size_t l = 0; l < lines; ++l)
+        {
+            const double ms = diffusionSpansMs[stage] * static_cast<double>(diffusionOrder[l] + 1) / numLines;
+            diffusionLength[stage][l] = nextPrime(juce::roundToInt(ms * 0.001 * sampleRate));
+            longestDiffusion = juce::jmax(longestDiffusion, diffusionLength[stage][l]);
+        }
+    }
+
+    diffusionSize = longestDiffusion + controlInterval;
+    diffusionRing.assign(numDiffusionStages * lines * static_cast<size_t>(diffusionSize), 0.0f);
+
+    for (auto* smoother : { &decaySmoothed, &dampingSmoothed, &inputGainSmoothed,
+                            &wet1Smoothed, &wet2Smoothed, &drySmoothed })
+        smoother->reset(sampleRate, 0.05);
+
+    reset();
+}
+
+void FdnReverb::reset()
+{
+    std::fill(ring.begin(), ring.end(), 0.0f);
+    std::fill(diffusionRing.begin(), diffusionRing.end(), 0.0f);
+    writePos = 0;
+    diffusionWritePos = 0;
+    lowpass.fill(0.0f);
+    lineGainDecay = 1.0f;       // Not a valid decay, so the gains are recomputed
+    controlPosition = 0;
+
+    for (size_t l = 0; l < lines; ++l)
+    {
+        const float phase = juce::MathConstants<float>::twoPi * static_cast<float>(l) / static_cast<float>(numLines);
+        lfoSin[l] = std::sin(phase);
+        lfoCos[l] = std::cos(phase);
+    }
+
+    updateTargets(true);
+}
+
+void FdnReverb::setParameters(const juce::dsp::Reverb::Parameters& newParams)
+{
+    params = newParams;
+    updateTargets(false);
+}
+
+void FdnReverb::setModulationDepth(float depth)
+{
+    modulationDepth = juce::jlimit(0.0f, 1.0f, depth);
+}
+
+float FdnReverb::getDecayTime() const noexcept
+{
+    const float feedback = 0.7f + 0.28f * params.roomSize;
+    return -3.0f * referenceLengthSeconds / std::log10(feedback);
+}
+
+void FdnReverb::updateTargets(bool snap)
+{
+    // Frozen: lossless feedback and no new input, so the tail holds
+    const bool frozen = params.freezeMode >= 0.5f;
+    const float feedback = frozen ? 1.0f : 0.7f + 0.28f * params.roomSize;
+    const float wetGain = params.wetLevel * wetScale;
+
+    const float targets[] = {
+        20.0f * std::log10(feedback) / referenceLengthSeconds,
+        frozen ? 0.0f : params.damping * 0.4f,
+        frozen ? 0.0f : inputScale,
+        0.5f * wetGain * (1.0f + params.width),
+        0.5f * wetGain * (1.0f - params.width),
+        params.dryLevel * dryScale
+    };
+
+    juce::SmoothedValue<float>* smoothers[] = { &decaySmoothed, &dampingSmoothed, &inputGainSmoothed,
+                                                &wet1Smoothed, &wet2Smoothed, &drySmoothed };
+
+    for (size_t i = 0; i < std::size(targets); ++i)
+    {
+        if (snap)
+            smoothers[i]->setCurrentAndTargetValue(targets[i]);
+        else
+            smoothers[i]->setTargetValue(targets[i]);
+    }
+}
+
+void FdnReverb::diffuseInput(const float* left, const float* right, int numSamples, float inputGain)
+{
+    // The stages use the unnormalised Hadamard matrix; their combined
+    // 1 / sqrt(numLines) per stage is applied once, on the way in
+    const float scale = inputGain / std::pow(std::sqrt(static_cast<float>(numLines)), static_cast<float>(numDiffusionStages));
+
+    for (size_t l = 0; l < lines; ++l)
+    {
+        const float gainL = injectLeft[l] * scale;
+        const float gainR = injectRight[l] * scale;
+        for (int i = 0; i < numSamples; ++i)
+            diffused[l][static_cast<size_t>(i)] = left[i] * gainL + right[i] * gainR;
+    }
+
+    for (size_t stage = 0; stage < numDiffusionStages; ++stage)
+    {
+        // Delay each line, flipping polarities on the way out
+        for (size_t l = 0; l < lines; ++l)
+        {
+            auto* history = diffusionRing.data() + (stage * lines + l) * static_cast<size_t>(diffusionSize);
+            auto* samples = diffused[l].data();
+
+            writeRing(history, diffusionSize, diffusionWritePos, samples, numSamples);
+
+            int readPos = diffusionWritePos - diffusionLength[stage][l];
+            if (readPos < 0)
+                readPos += diffusionSize;
+            readRing(history, diffusionSize, readPos, samples, numSamples, diffusionFlips[stage][l]);
+        }
+
+        // Hadamard across the lines: each butterfly runs over the whole chunk
+        for (size_t h = 1; h < lines; h *= 2)
+        {
+            for (size_t j = 0; j < lines; j += 2 * h)
+            {
+                for (size_t k = j; k < j + h; ++k)
+                {
+                    auto* a = diffused[k].data();
+                    auto* b = diffused[k + h].data();
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const float sum = a[i] + b[i];
+                        b[i] = a[i] - b[i];
+                        a[i] = sum;
+                    }
+                }
+            }
+        }
+    }
+
+    diffusionWritePos += numSamples;
+    if (diffusionWritePos >= diffusionSize)
+        diffusionWritePos -= diffusionSize;
+}
+
+template <bool Modulated>
+void FdnReverb::readLines(int numSamples)
+{
+    const float modulationSamples = modulationDepth * maxModulationMs * 0.001f * static_cast<float>(sampleRate);
+
+    for (size_t l = 0; l < lines; ++l)
+    {
+        const auto* history = ring.data() + l * static_cast<size_t>(ringSize);
+
+        if constexpr (Modulated)
+        {
+            // The LFO advances once per control period and the delay ramps
+            // linearly between its values, so the samples carry no serial
+            // dependency
+            const float s = lfoSin[l];
+            const float delayStep = modulationSamples * (lfoNextSin[l] - s) / static_cast<float>(controlInterval);
+            const float startDelay = static_cast<float>(lineLength[l]) + modulationSamples * s;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                // The delay never drops near zero, so truncation is floor
+                const float delay = startDelay + delayStep * static_cast<float>(controlPosition + i);
+                const int whole = static_cast<int>(delay);
+                const float frac = delay - static_cast<float>(whole);
+
+                int index = writePos + i - whole;
+                if (index < 0)
+                    index += ringSize;
+                const int older = index > 0 ? index - 1 : ringSize - 1;
+                frames[static_cast<size_t>(i) * lines + l] = history[index] + frac * (history[older] - history[index]);
+            }
+        }
+        else
+        {
+            int readPos = writePos - lineLength[l];
+            if (readPos < 0)
+                readPos += ringSize;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                frames[static_cast<size_t>(i) * lines + l] = history[readPos];
+                if (++readPos == ringSize)
+                    readPos = 0;
+            }
+        }
+    }
+}
+
+void FdnReverb::mixLines(int numSamples, float dampCoeff)
+{
+    // One frame per sample, eight lanes wide: damping, decay and the
+    // feedback matrix. The output taps are rows 1 and 2 of the Hadamard
+    // product, so they come out of the butterflies for free
+    const float scale = 1.0f / std::sqrt(static_cast<float>(numLines));
+
+    // Local copies, so the frame stores can't alias the filter state
+    LineArray state = lowpass;
+    const LineArray gain = lineGain;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float* frame = frames.data() + static_cast<size_t>(i) * lines;
+
+        LineArray v;
+        for (size_t l = 0; l < lines; ++l)
+        {
+            state[l] = frame[l] + dampCoeff * (state[l] - frame[l]);
+            v[l] = state[l] * gain[l];
+        }
+
+        // Each butterfly stage pairs lane k with lane k ^ h; written
+        // lane-wise, the eight lanes stay in registers
+        for (size_t h = 1; h < lines; h *= 2)
+        {
+            LineArray partner;
+            for (size_t k = 0; k < lines; ++k)
+                partner[k] = v[k ^ h];
+            for (size_t k = 0; k < lines; ++k)
+                v[k] = partner[k] + ((k & h) != 0 ? -v[k] : v[k]);
+        }
+
+        tapL[static_cast<size_t>(i)] = v[1];
+        tapR[static_cast<size_t>(i)] = v[2];
+
+        for (size_t l = 0; l < lines; ++l)
+            frame[l] = v[l] * scale;
+    }
+
+    lowpass = state;
+}
+
+void FdnReverb::writeLines(int numSamples)
+{
+    for (size_t l = 0; l < lines; ++l)
+    {
+        auto* history = ring.data() + l * static_cast<size_t>(ringSize);
+        const auto* input = diffused[l].data();
+        int pos = writePos;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            history[pos] = frames[static_cast<size_t>(i) * lines + l] + input[i];
+            if (++pos == ringSize)
+                pos = 0;
+        }
+    }
+
+    writePos += numSamples;
+    if (writePos >= ringSize)
+        writePos -= ringSize;
+}
+
+void FdnReverb::process(juce::dsp::AudioBlock<float>& block)
+{
+    const auto numChannels = block.getNumChannels();
+    if (numChannels == 0)
+        return;
+
+    jassert(numChannels <= 2);
+    auto* left = block.getChannelPointer(0);
+    auto* right = numChannels > 1 ? block.getChannelPointer(1) : left;
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+
+    for (int start = 0; start < numSamples;)
+    {
+        // A chunk runs to the end of the block or of the control period,
+        // whichever comes first
+        if (controlPosition == 0)
+            updateControl();
+
+        const int n = juce::jmin(controlInterval - controlPosition, numSamples - start);
+        float* chunkL = left + start;
+        float* chunkR = right + start;
+
+        diffuseInput(chunkL, chunkR, n, controlInputGain);
+
+        if (modulationDepth > 0.0f)
+            readLines<true>(n);
+        else
+            readLines<false>(n);
+
+        mixLines(n, controlDamping);
+        writeLines(n);
+
+        if (numChannels > 1)
+            renderOutput(chunkL, chunkR, n);
+        else
+            renderOutput(chunkL, nullptr, n);
+
+        start += n;
+        controlPosition += n;
+        if (controlPosition == controlInterval)
+        {
+            controlPosition = 0;
+            advanceModulation();
+        }
+    }
+}
+
+void FdnReverb::updateControl()
+{
+    // Decay gains, damping and input gain are held for the period
+    const float decayDbPerSample = decaySmoothed.skip(controlInterval) / static_cast<float>(sampleRate);
+    controlDamping = dampingSmoothed.skip(controlInterval);
+    controlInputGain = inputGainSmoothed.skip(controlInterval);
+
+    if (decayDbPerSample != lineGainDecay)
+    {
+        lineGainDecay = decayDbPerSample;
+        for (size_t l = 0; l < lines; ++l)
+            lineGain[l] = juce::Decibels::decibelsToGain(decayDbPerSample * static_cast<float>(lineLength[l]));
+    }
+
+    // Where the modulation phasors will be at the end of the period
+    for (size_t l = 0; l < lines; ++l)
+    {
+        lfoNextSin[l] = lfoSin[l] * lfoChunkCos[l] + lfoCos[l] * lfoChunkSin[l];
+        lfoNextCos[l] = lfoCos[l] * lfoChunkCos[l] - lfoSin[l] * lfoChunkSin[l];
+    }
+}
+
+void FdnReverb::advanceModulation()
+{
+    // Pull the phasors back onto the unit circle before rounding drift builds up
+    for (size_t l = 0; l < lines; ++l)
+    {
+        const float norm = 1.0f / std::sqrt(lfoNextSin[l] * lfoNextSin[l] + lfoNextCos[l] * lfoNextCos[l]);
+        lfoSin[l] = lfoNextSin[l] * norm;
+        lfoCos[l] = lfoNextCos[l] * norm;
+    }
+}
+
+void FdnReverb::renderOutput(float* left, float* right, int numSamples)
+{
+    // Width and wet/dry, as juce::dsp::Reverb applies them. A mono block
+    // gets the average of the two wet sides
+    const bool smoothing = wet1Smoothed.isSmoothing() || wet2Smoothed.isSmoothing() || drySmoothed.isSmoothing();
+    float wet1 = wet1Smoothed.getCurrentValue();
+    float wet2 = wet2Smoothed.getCurrentValue();
+    float dry = drySmoothed.getCurrentValue();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (smoothing)
+        {
+            wet1 = wet1Smoothed.getNextValue();
+            wet2 = wet2Smoothed.getNextValue();
+            dry = drySmoothed.getNextValue();
+        }
+
+        const float outL = tapL[static_cast<size_t>(i)];
+        const float outR = tapR[static_cast<size_t>(i)];
+        const float wetL = outL * wet1 + outR * wet2;
+        const float wetR = outR * wet1 + outL * wet2;
+
+        if (right != nullptr)
+        {
+            left[i] = wetL + left[i] * dry;
+            right[i] = wetR + right[i] * dry;
+        }
+        else
+        {
+            left[i] = 0.5f * (wetL + wetR) + left[i] * dry;
+        }
+    }
+}
+
+int FdnReverb::nextPrime(int n)
+{
+    auto isPrime = [](int x)
+    {
+        if (x < 2)
+            return false;
+        for (int d = 2; d * d <= x; ++d)
+            if (x % d == 0)
+                return false;
+        return true;
+    };
+
+    while (! isPrime(n))
+        ++n;
+    return n;
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+
+/**
+ * @brief Feedback-delay-network reverb
+ *
+ * Eight prime-length delay lines, each with a one-pole damping filter and a
+ * decay gain, fed back through an orthonormal Hadamard matrix. The input is
+ * smeared through three Hadamard diffusion stages first, so the tail is
+ * dense from the start. Takes the same parameters as juce::dsp::Reverb so
+ * the two engines are interchangeable, and the line lengths can optionally
+ * be modulated to break up the modal ringing of long tails.
+ *
+ * Processing runs in chunks no longer than the shortest line, so a chunk
+ * never reads what it writes: the delay reads and diffusion become
+ * contiguous per-line copies and the matrix work vectorises. Chunks follow
+ * the control periods of the stream rather than the block, so the output
+ * doesn't depend on the block size.
+ */
+class FdnReverb
+{
+public:
+    static constexpr int numLines = 8;
+
+    FdnReverb();
+    ~FdnReverb() = default;
+
+    //==============================================================================
+    /** Prepares the processor for playback; the line lengths depend on the sample rate */
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    /** Clears the delay lines and snaps the smoothed parameters to their targets */
+    void reset();
+
+    //==============================================================================
+    /** Sets room size, damping, wet/dry levels, width and freeze mode */
+    void setParameters(const juce::dsp::Reverb::Parameters& newParams);
+
+    /** Returns the current parameters */
+    const juce::dsp::Reverb::Parameters& getParameters() const noexcept { return params; }
+
+    /** Sets the delay line modulation depth (0.0 = static lines, 1.0 = +/-0.5ms) */
+    void setModulationDepth(float depth);
+
+    /** Returns the 60dB decay time for the current room size, ignoring freeze, in seconds */
+    float getDecayTime() const noexcept;
+
+    //==============================================================================
+    /** Processes a mono or stereo block in place */
+    void process(juce::dsp::AudioBlock<float>& block);
+
+private:
+    //==============================================================================
+    static constexpr size_t lines = static_cast<size_t>(numLines);
+    static constexpr size_t numDiffusionStages = 3;
+
+    // Decay, damping and the modulation targets are recomputed once per
+    // control period; the output gains are smoothed per sample
+    static constexpr int controlInterval = 128;
+
+    using LineArray = std::array<float, lines>;
+
+    // Per-line state in structure-of-arrays form
+    std::array<int, lines> lineLength {};
+    LineArray lineGain {};          // Decay gain per pass through the line
+    float lineGainDecay = 1.0f;     // The decay (dB per sample) lineGain was computed for
+    LineArray lowpass {};           // Damping filter state
+    LineArray lfoSin {};            // Modulation phasor, rotated once per control period
+    LineArray lfoCos {};
+    LineArray lfoNextSin {};        // The phasor at the end of the current period
+    LineArray lfoNextCos {};
+    LineArray lfoChunkSin {};       // Rotation over a full period
+    LineArray lfoChunkCos {};
+
+    // Position in the current control period, and the values held over it
+    int controlPosition = 0;
+    float controlDamping = 0.0f;
+    float controlInputGain = 0.0f;
+
+    // Delay history, one ring per line laid end to end
+    std::vector<float> ring;
+    int ringSize = 0;
+    int writePos = 0;
+
+    // Input diffusion: each stage delays every line by a different short
+    // prime length, flips some polarities and mixes through the Hadamard
+    // matrix. One ring per stage and line, laid end to end
+    std::array<std::array<int, lines>, numDiffusionStages> diffusionLength {};
+    std::vector<float> diffusionRing;
+    int diffusionSize = 0;
+    int diffusionWritePos = 0;
+
+    // Chunk scratch: the diffused input per line, the delayed frames
+    // interleaved as [sample][line], and the two output taps
+    std::array<std::array<float, controlInterval>, lines> diffused {};
+    std::array<float, controlInterval * lines> frames {};
+    std::array<float, controlInterval> tapL {};
+    std::array<float, controlInterval> tapR {};
+
+    juce::dsp::Reverb::Parameters params;
+    double sampleRate = 44100.0;
+    float modulationDepth = 0.0f;
+
+    juce::SmoothedValue<float> decaySmoothed;       // Level change per second (dB, negative)
+    juce::SmoothedValue<float> dampingSmoothed;
+    juce::SmoothedValue<float> inputGainSmoothed;   // Muted while frozen
+    juce::SmoothedValue<float> wet1Smoothed;        // Same-side wet gain
+    juce::SmoothedValue<float> wet2Smoothed;        // Cross-side wet gain
+    juce::SmoothedValue<float> drySmoothed;
+
+    //==============================================================================
+    void updateTargets(bool snap);
+    void updateControl();
+    void advanceModulation();
+
+    void diffuseInput(const float* left, const float* right, int numSamples, float inputGain);
+    template <bool Modulated>
+    void readLines(int numSamples);
+    void mixLines(int numSamples, float dampCoeff);
+    void writeLines(int numSamples);
+    void renderOutput(float* left, float* right, int numSamples);
+
+    static int nextPrime(int n);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FdnReverb)
+};
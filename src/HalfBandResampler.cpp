@@ -0,0 +1,279 @@
+#include "HalfBandResampler.h"
+
+namespace
+{
+    constexpr double stopbandAttenuationDb = 90.0;
+    constexpr double maxPassbandHz = 20000.0;
+
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (x * 0.5) / k;
+            sum += term * term;
+
+            if (term * term < sum * 1.0e-16)
+                break;
+        }
+
+        return sum;
+    }
+
+    // Kaiser-windowed half-band lowpass of length 4K - 1. The sinc has a zero
+    // at every even offset from the centre and the centre tap is 0.5, so only
+    // the odd offsets on one side need storing
+    std::vector<float> designHalfBand(double transitionWidth)
+    {
+        const double beta = 0.1102 * (stopbandAttenuationDb - 8.7);
+        const int estimatedLength = static_cast<int>(std::ceil((stopbandAttenuationDb - 7.95) / (14.36 * transitionWidth))) + 1;
+        const int numTaps = juce::jmax(1, (estimatedLength + 4) / 4);
+        const double centre = 2.0 * numTaps - 1.0;
+
+        std::vector<double> taps(static_cast<size_t>(numTaps));
+        double sum = 0.0;
+
+        for (int j = 0; j < numTaps; ++j)
+        {
+            const double offset = 2.0 * j + 1.0;
+            const double sinc = std::sin(juce::MathConstants<double>::halfPi * offset) / (juce::MathConstants<double>::pi * offset);
+            const double ratio = offset / centre;
+            const double window = besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - ratio * ratio))) / besselI0(beta);
+
+            taps[static_cast<size_t>(j)] = sinc * window;
+            sum += taps[static_cast<size_t>(j)];
+        }
+
+        // Unity gain at DC: the centre tap plus both sides sum to one
+        std::vector<float> result(static_cast<size_t>(numTaps));
+        for (int j = 0; j < numTaps; ++j)
+            result[static_cast<size_t>(j)] = static_cast<float>(taps[static_cast<size_t>(j)] * 0.25 / sum);
+
+        return result;
+    }
+}
+
+//==============================================================================
+void HalfBandResampler::Stage::prepare(double stageRate, int numChannels, int maxInputSamples)
+{
+    // The passband ends at 80% of the lower rate's Nyquist frequency, or at
+    // 20kHz when the lower rate is high enough to leave more room than that
+    const double passband = juce::jmin(maxPassbandHz, stageRate * 0.2);
+    taps = designHalfBand((stageRate * 0.5 - 2.0 * passband) / stageRate);
+    numTaps = static_cast<int>(taps.size());
+    maxInput = maxInputSamples;
+
+    const int maxPairs = (maxInput + 1) / 2;
+    const int history = 2 * numTaps - 1;
+
+    evenPhase.setSize(numChannels, history + maxPairs);
+    oddPhase.setSize(numChannels, numTaps + maxPairs);
+    decimated.setSize(numChannels, maxPairs);
+    pendingSample.assign(static_cast<size_t>(numChannels), 0.0f);
+
+    interpolatorInput.setSize(numChannels, history + maxPairs);
+    interpolated.setSize(numChannels, 2 * maxPairs);
+    evenOutput.assign(static_cast<size_t>(maxPairs), 0.0f);
+
+    reset();
+}
+
+void HalfBandResampler::Stage::reset()
+{
+    evenPhase.clear();
+    oddPhase.clear();
+    interpolatorInput.clear();
+    std::fill(pendingSample.begin(), pendingSample.end(), 0.0f);
+    hasPending = false;
+}
+
+int HalfBandResampler::Stage::decimate(const juce::dsp::AudioBlock<float>& input)
+{
+    const int numSamples = static_cast<int>(input.getNumSamples());
+    const int numChannels = juce::jmin(static_cast<int>(input.getNumChannels()), evenPhase.getNumChannels());
+    const int total = numSamples + (hasPending ? 1 : 0);
+    const int numPairs = total / 2;
+    const int history = 2 * numTaps - 1;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* in = input.getChannelPointer(static_cast<size_t>(channel));
+        float* even = evenPhase.getWritePointer(channel);
+        float* odd = oddPhase.getWritePointer(channel);
+        float* out = decimated.getWritePointer(channel);
+
+        // Split the new samples into their phases behind the history; a
+        // sample left over from the last block opens the first pair
+        const int first = hasPending ? 1 : 0;
+        const float* pairs = in - first;
+
+        if (hasPending && numPairs > 0)
+        {
+            even[history] = pendingSample[static_cast<size_t>(channel)];
+            odd[numTaps] = in[0];
+        }
+
+        for (int i = first; i < numPairs; ++i)
+        {
+            even[history + i] = pairs[2 * i];
+            odd[numTaps + i] = pairs[2 * i + 1];
+        }
+
+        if ((total % 2) != 0)
+            pendingSample[static_cast<size_t>(channel)] = in[numSamples - 1];
+
+        // Centre tap on the odd phase, symmetric pairs of taps on the even one
+        juce::FloatVectorOperations::multiply(out, odd, 0.5f, numPairs);
+
+        for (int j = 0; j < numTaps; ++j)
+        {
+            const float tap = taps[static_cast<size_t>(j)];
+            const float* newer = even + numTaps + j;
+            const float* older = even + numTaps - 1 - j;
+
+            for (int i = 0; i < numPairs; ++i)
+                out[i] += tap * (newer[i] + older[i]);
+        }
+
+        std::memmove(even, even + numPairs, static_cast<size_t>(history) * sizeof(float));
+        std::memmove(odd, odd + numPairs, static_cast<size_t>(numTaps) * sizeof(float));
+    }
+
+    hasPending = (total % 2) != 0;
+    return numPairs;
+}
+
+void HalfBandResampler::Stage::interpolate(const juce::dsp::AudioBlock<float>& input)
+{
+    const int numSamples = static_cast<int>(input.getNumSamples());
+    const int numChannels = juce::jmin(static_cast<int>(input.getNumChannels()), interpolatorInput.getNumChannels());
+    const int history = 2 * numTaps - 1;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* in = interpolatorInput.getWritePointer(channel);
+        float* out = interpolated.getWritePointer(channel);
+        float* even = evenOutput.data();
+
+        juce::FloatVectorOperations::copy(in + history, input.getChannelPointer(static_cast<size_t>(channel)), numSamples);
+
+        // The even outputs come from the symmetric taps at twice their gain,
+        // the odd ones straight through the centre tap
+        juce::FloatVectorOperations::clear(even, numSamples);
+
+        for (int j = 0; j < numTaps; ++j)
+        {
+            const float tap = 2.0f * taps[static_cast<size_t>(j)];
+            const float* newer = in + numTaps + j;
+            const float* older = in + numTaps - 1 - j;
+
+            for (int i = 0; i < numSamples; ++i)
+                even[i] += tap * (newer[i] + older[i]);
+        }
+
+        const float* centre = in + numTaps;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            out[2 * i] = even[i];
+            out[2 * i + 1] = centre[i];
+        }
+
+        std::memmove(in, in + numSamples, static_cast<size_t>(history) * sizeof(float));
+    }
+}
+
+//==============================================================================
+void HalfBandResampler::prepare(double sampleRate, int newNumChannels, int maxBlockSize, int newFactor)
+{
+    jassert(newFactor == 1 || newFactor == 2 || newFactor == 4);
+
+    factor = newFactor;
+    numChannels = newNumChannels;
+    stages.clear();
+    latency = 0;
+
+    int stageInput = maxBlockSize;
+    double stageRate = sampleRate;
+
+    for (int stageFactor = 1; stageFactor < factor; stageFactor *= 2)
+    {
+        stages.emplace_back();
+        stages.back().prepare(stageRate, numChannels, stageInput);
+
+        // Each filter delays by 2K - 1 samples at the stage's higher rate, on
+        // the way down and again on the way up
+        latency += 2 * stageFactor * (2 * stages.back().numTaps - 1);
+
+        stageInput = (stageInput + 1) / 2;
+        stageRate *= 0.5;
+    }
+
+    maxReducedBlockSize = stageInput;
+
+    // The FIFO starts with factor - 1 samples so that every block can be
+    // filled however the block sizes fall against the factor
+    latency += factor - 1;
+    outputFifo.setSize(numChannels, maxBlockSize + 2 * factor);
+    reset();
+}
+
+void HalfBandResampler::reset()
+{
+    for (auto& stage : stages)
+        stage.reset();
+
+    outputFifo.clear();
+    fifoCount = factor - 1;
+}
+
+juce::dsp::AudioBlock<float> HalfBandResampler::decimate(const juce::dsp::AudioBlock<float>& input)
+{
+    if (stages.empty())
+        return input;
+
+    auto block = input;
+    for (auto& stage : stages)
+    {
+        const int numOutput = stage.decimate(block);
+        block = juce::dsp::AudioBlock<float>(stage.decimated).getSubBlock(0, static_cast<size_t>(numOutput))
+                                                             .getSubsetChannelBlock(0, block.getNumChannels());
+    }
+
+    return block;
+}
+
+void HalfBandResampler::interpolate(const juce::dsp::AudioBlock<float>& reduced, juce::dsp::AudioBlock<float>& output)
+{
+    if (stages.empty())
+    {
+        if (reduced.getChannelPointer(0) != output.getChannelPointer(0))
+            output.copyFrom(reduced);
+        return;
+    }
+
+    auto block = reduced;
+    for (auto it = stages.rbegin(); it != stages.rend(); ++it)
+    {
+        it->interpolate(block);
+        block = juce::dsp::AudioBlock<float>(it->interpolated).getSubBlock(0, 2 * block.getNumSamples())
+                                                              .getSubsetChannelBlock(0, block.getNumChannels());
+    }
+
+    const int numNew = static_cast<int>(block.getNumSamples());
+    const int numOutput = static_cast<int>(output.getNumSamples());
+    const int numChannelsToUse = juce::jmin(numChannels, static_cast<int>(output.getNumChannels()));
+    jassert(fifoCount + numNew >= numOutput && fifoCount + numNew <= outputFifo.getNumSamples());
+
+    for (int channel = 0; channel < numChannelsToUse; ++channel)
+    {
+        float* fifo = outputFifo.getWritePointer(channel);
+
+        juce::FloatVectorOperations::copy(fifo + fifoCount, block.getChannelPointer(static_cast<size_t>(channel)), numNew);
+        juce::FloatVectorOperations::copy(output.getChannelPointer(static_cast<size_t>(channel)), fifo, numOutput);
+        std::memmove(fifo, fifo + numOutput, static_cast<size_t>(fifoCount + numNew - numOutput) * sizeof(float));
+    }
+
+    fifoCount += numNew - numOutput;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+/**
+ * @brief Decimates by 2 or 4 and interpolates back with polyphase half-band FIRs
+ *
+ * Each 2x stage is a linear-phase half-band lowpass. Every other tap of a
+ * half-band filter is zero, so both directions split into two polyphase
+ * branches: a symmetric branch over the even samples, and a plain delay
+ * through the centre tap for the odd ones. The filters pass 80% of the
+ * reduced-rate Nyquist frequency (at most 20kHz) with 90dB of stopband
+ * rejection, and are designed for the sample rate in prepare().
+ *
+ * Blocks of any size go through; a short output FIFO covers blocks that
+ * don't divide by the factor, and its fill is part of the reported latency.
+ */
+class HalfBandResampler
+{
+public:
+    HalfBandResampler() = default;
+    ~HalfBandResampler() = default;
+
+    //==============================================================================
+    /** Prepares for a factor of 1 (pass-through), 2 or 4; maxBlockSize is at the full rate */
+    void prepare(double sampleRate, int numChannels, int maxBlockSize, int newFactor);
+
+    /** Clears the filter histories */
+    void reset();
+
+    //==============================================================================
+    /** Returns the resampling factor */
+    int getFactor() const noexcept { return factor; }
+
+    /** Returns the delay of a decimate and interpolate round trip, in full-rate samples */
+    int getLatencySamples() const noexcept { return latency; }
+
+    /** Returns the largest block decimate() can produce */
+    int getMaxReducedBlockSize() const noexcept { return maxReducedBlockSize; }
+
+    //==============================================================================
+    /** Decimates a full-rate block; the result stays valid until the next call */
+    juce::dsp::AudioBlock<float> decimate(const juce::dsp::AudioBlock<float>& input);
+
+    /** Interpolates a reduced-rate block, filling the whole of the full-rate output */
+    void interpolate(const juce::dsp::AudioBlock<float>& reduced, juce::dsp::AudioBlock<float>& output);
+
+private:
+    //==============================================================================
+    struct Stage
+    {
+        std::vector<float> taps;            // Odd taps on one side of the centre
+        int numTaps = 0;
+        int maxInput = 0;                   // At the stage's higher rate
+
+        // Decimator: history plus the current block, split into the two phases
+        juce::AudioBuffer<float> evenPhase;
+        juce::AudioBuffer<float> oddPhase;
+        juce::AudioBuffer<float> decimated;
+        std::vector<float> pendingSample;   // Unpaired sample left over from the last block
+        bool hasPending = false;
+
+        // Interpolator: history plus the current block at the lower rate
+        juce::AudioBuffer<float> interpolatorInput;
+        juce::AudioBuffer<float> interpolated;
+        std::vector<float> evenOutput;
+
+        void prepare(double stageRate, int numChannels, int maxInputSamples);
+        void reset();
+        int decimate(const juce::dsp::AudioBlock<float>& input);
+        void interpolate(const juce::dsp::AudioBlock<float>& input);
+    };
+
+    std::vector<Stage> stages;
+    int factor = 1;
+    int latency = 0;
+    int maxReducedBlockSize = 0;
+    int numChannels = 0;
+
+    // Full-rate output waiting to be handed back
+    juce::AudioBuffer<float> outputFifo;
+    int fifoCount = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HalfBandResampler)
+};
@@ -2,48 +2,89 @@
 #include <cmath>
 #include <algorithm>
 
+namespace
+{
+    // Third-order Lagrange read from a single-channel power-of-two ring; a
+    // delay of k samples lands on ring[writePos - k]
+    inline float readLagrange3(const float* ring, int mask, int writePos, float delay)
+    {
+        const int delayInt = static_cast<int>(delay) - 1;
+        const float frac = delay - static_cast<float>(delayInt);
+        const int newest = writePos - delayInt;
+
+        const float v1 = ring[newest & mask];
+        const float v2 = ring[(newest - 1) & mask];
+        const float v3 = ring[(newest - 2) & mask];
+        const float v4 = ring[(newest - 3) & mask];
+
+        const float d1 = frac - 1.0f;
+        const float d2 = frac - 2.0f;
+        const float d3 = frac - 3.0f;
+
+        const float c1 = -d1 * d2 * d3 * (1.0f / 6.0f);
+        const float c2 = d2 * d3 * 0.5f;
+        const float c3 = -d1 * d3 * 0.5f;
+        const float c4 = d1 * d2 * (1.0f / 6.0f);
+
+        return v1 * c1 + frac * (v2 * c2 + v3 * c3 + v4 * c4);
+    }
+}
+
+const std::array<MicroPitchDetune::VoiceKernel, MicroPitchDetune::MAX_VOICES> MicroPitchDetune::voiceKernels = {
+    &MicroPitchDetune::processVoices<1>,
+    &MicroPitchDetune::processVoices<2>,
+    &MicroPitchDetune::processVoices<3>,
+    &MicroPitchDetune::processVoices<4>,
+    &MicroPitchDetune::processVoices<5>,
+    &MicroPitchDetune::processVoices<6>,
+    &MicroPitchDetune::processVoices<7>,
+    &MicroPitchDetune::processVoices<8>
+};
+
 MicroPitchDetune::MicroPitchDetune()
-    : randomEngine(std::random_device{}()),
-    randomDistribution(0.0f, 1.0f)
 {
+    voiceKernel = voiceKernels[static_cast<size_t>(numVoices - 1)];
 }
 
 void MicroPitchDetune::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = static_cast<float>(spec.sampleRate);
 
-    // Prepare all delay taps
-    for (auto& tap : tapsL)
+    // Delay history for all voices: the longest delay plus the interpolator's
+    // reach, rounded up to a power of two so positions wrap with a mask
+    const int maxDelaySamples = static_cast<int>(sampleRate * maxDelayTime) + 4;
+    const int ringSize = juce::nextPowerOfTwo(maxDelaySamples);
+    ringMask = ringSize - 1;
+    ring.assign(static_cast<size_t>(ringSize * MAX_LANES), 0.0f);
+    ringSpare.assign(ring.size(), 0.0f);
+
+    // Granular engine history covers the longest grain delay
+    grainSamples = std::round(sampleRate * grainTime);
+    const int grainRingSize = juce::nextPowerOfTwo(static_cast<int>(grainMinDelay + grainSamples) + 4);
+    grainRingMask = grainRingSize - 1;
+    grainRingL.assign(static_cast<size_t>(grainRingSize), 0.0f);
+    grainRingR.assign(static_cast<size_t>(grainRingSize), 0.0f);
+
+    windowTable.resize(windowTableSize + 1);
+    for (int i = 0; i <= windowTableSize; ++i)
     {
-        tap.delay.prepare(spec);
-        const int maxDelaySamples = static_cast<int>(sampleRate * maxDelayTime) + 1;
-        tap.delay.setMaximumDelayInSamples(maxDelaySamples);
-        tap.smoothedDelay.reset(sampleRate, 0.05);  // 50ms smoothing
-        tap.phaseOffset = randomDistribution(randomEngine) * juce::MathConstants<float>::twoPi;
+        const float s = std::sin(juce::MathConstants<float>::pi * static_cast<float>(i) / windowTableSize);
+        windowTable[static_cast<size_t>(i)] = s * s;
     }
 
-    for (auto& tap : tapsR)
-    {
-        tap.delay.prepare(spec);
-        const int maxDelaySamples = static_cast<int>(sampleRate * maxDelayTime) + 1;
-        tap.delay.setMaximumDelayInSamples(maxDelaySamples);
-        tap.smoothedDelay.reset(sampleRate, 0.05);
-        tap.phaseOffset = randomDistribution(randomEngine) * juce::MathConstants<float>::twoPi;
-    }
+    wetBufferL.assign(spec.maximumBlockSize, 0.0f);
+    wetBufferR.assign(spec.maximumBlockSize, 0.0f);
 
-    // Setup DC blockers (high-pass at 5Hz)
-    auto dcCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 5.0f);
-    dcBlockerL.coefficients = dcCoeffs;
-    dcBlockerR.coefficients = dcCoeffs;
+    // 50ms delay smoothing
+    delaySmoothingCoeff = 1.0 / (static_cast<double>(sampleRate) * 0.05);
 
-    juce::dsp::ProcessSpec monoSpec = spec;
-    monoSpec.numChannels = 1;
-    dcBlockerL.prepare(monoSpec);
-    dcBlockerR.prepare(monoSpec);
+    // Setup DC blockers (high-pass at 5Hz), one state per voice; a0 is already 1
+    dcCoefficients = juce::dsp::IIR::ArrayCoefficients<double>::makeHighPass(sampleRate, 5.0);
 
-    // Anti-aliasing smoother for modulation
-    modulationSmoother.reset(sampleRate, 0.002);  // 2ms for smooth modulation
+    // Anti-aliasing smoother for modulation, 2ms per voice
+    modulationSmoothingCoeff = 1.0f / (sampleRate * 0.002f);
 
+    randomiseTapPhases();
     updateTapOffsets();
     reset();
 }
@@ -52,22 +93,28 @@ void MicroPitchDetune::reset()
 {
     modPhase = 0.0f;
 
-    for (auto& tap : tapsL)
-    {
-        tap.delay.reset();
-        tap.feedback = 0.0f;
-        tap.smoothedDelay.setCurrentAndTargetValue(delayCentre * sampleRate);
-    }
+    std::fill(ring.begin(), ring.end(), 0.0f);
+    writePos = 0;
 
-    for (auto& tap : tapsR)
-    {
-        tap.delay.reset();
-        tap.feedback = 0.0f;
-        tap.smoothedDelay.setCurrentAndTargetValue(delayCentre * sampleRate);
-    }
+    lanes.smoothedDelay.fill(static_cast<double>(delayCentre * sampleRate));
+    lanes.modulation.fill(0.0f);
+    lanes.feedback.fill(0.0f);
+    lanes.dcState1.fill(0.0);
+    lanes.dcState2.fill(0.0);
+
+    resetGrains();
+}
 
-    dcBlockerL.reset();
-    dcBlockerR.reset();
+void MicroPitchDetune::resetGrains()
+{
+    std::fill(grainRingL.begin(), grainRingL.end(), 0.0f);
+    std::fill(grainRingR.begin(), grainRingR.end(), 0.0f);
+    grainWritePos = 0;
+
+    // Both channels start with head B alone, on the reported latency, so an
+    // unshifted wet path lines up with the dry on both sides. The channels
+    // drift apart only as far as they shift in opposite directions
+    grainPhase = { 0.0f, 0.0f };
 }
 
 void MicroPitchDetune::setParams(float detuneCentsIn, float lfoRateIn, float lfoDepthIn,
@@ -112,11 +159,117 @@ void MicroPitchDetune::setSyncEnabled(bool shouldSync)
     syncEnabled = shouldSync;
 }
 
+void MicroPitchDetune::setNumVoices(int newNumVoices)
+{
+    newNumVoices = juce::jlimit(1, MAX_VOICES, newNumVoices);
+    if (newNumVoices == numVoices)
+        return;
+
+    const int oldNumVoices = numVoices;
+    numVoices = newNumVoices;
+    voiceKernel = voiceKernels[static_cast<size_t>(numVoices - 1)];
+
+    if (!ring.empty())
+        relayoutVoices(oldNumVoices);
+
+    updateTapOffsets();
+}
+
+#if ECHOPSYCHFX_TESTS
+void MicroPitchDetune::setUseReferenceKernel(bool shouldUse)
+{
+    useReferenceKernel = shouldUse;
+}
+#endif
+
+void MicroPitchDetune::setEngine(Engine newEngine)
+{
+    if (newEngine == engine)
+        return;
+
+    // The idle engine's history is stale; start the new one from silence
+    engine = newEngine;
+    if (engine == Engine::Granular)
+        resetGrains();
+    else
+        std::fill(ring.begin(), ring.end(), 0.0f);
+}
+
+int MicroPitchDetune::getLatencySamples() const
+{
+    // The grain read heads sweep from grainMinDelay to grainMinDelay + one
+    // grain, so on average the output lags by half a grain
+    if (engine != Engine::Granular)
+        return 0;
+
+    return static_cast<int>(std::round(grainMinDelay + 0.5f * grainSamples));
+}
+
+void MicroPitchDetune::relayoutVoices(int oldNumVoices)
+{
+    // Voices beyond the old count start as copies of an existing voice, so
+    // their history is continuous and only their LFOs set them apart
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        for (int v = oldNumVoices; v < numVoices; ++v)
+        {
+            const auto dst = static_cast<size_t>(ch * MAX_VOICES + v);
+            const auto src = static_cast<size_t>(ch * MAX_VOICES + v % oldNumVoices);
+            lanes.smoothedDelay[dst] = lanes.smoothedDelay[src];
+            lanes.modulation[dst] = lanes.modulation[src];
+            lanes.feedback[dst] = lanes.feedback[src];
+            lanes.dcState1[dst] = lanes.dcState1[src];
+            lanes.dcState2[dst] = lanes.dcState2[src];
+        }
+    }
+
+    const auto oldStride = static_cast<size_t>(2 * oldNumVoices);
+    const auto newStride = static_cast<size_t>(2 * numVoices);
+    const auto numPositions = static_cast<size_t>(ringMask + 1);
+
+    for (size_t pos = 0; pos < numPositions; ++pos)
+    {
+        const float* src = ring.data() + pos * oldStride;
+        float* dst = ringSpare.data() + pos * newStride;
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int v = 0; v < numVoices; ++v)
+                dst[ch * numVoices + v] = src[ch * oldNumVoices + v % oldNumVoices];
+    }
+
+    std::swap(ring, ringSpare);
+}
+
 void MicroPitchDetune::setBpm(float newBpm)
 {
     bpm = juce::jlimit(20.0f, 300.0f, newBpm);
 }
 
+void MicroPitchDetune::setPpqPosition(double ppqPosition)
+{
+    // Synced rate is lfoRate cycles per beat
+    if (syncEnabled)
+    {
+        const double cycles = ppqPosition * static_cast<double>(lfoRate);
+        modPhase = static_cast<float>(cycles - std::floor(cycles));
+    }
+}
+
+void MicroPitchDetune::setSeed(juce::uint64 newSeed)
+{
+    random.setSeed(newSeed);
+    randomiseTapPhases();
+}
+
+void MicroPitchDetune::randomiseTapPhases()
+{
+    // Draw from the start of the sequence so a given seed always yields the
+    // same offsets, however often prepare() runs
+    random.reset();
+    random.fillUniform(lanes.phaseOffset.data(), MAX_LANES);
+    juce::FloatVectorOperations::multiply(lanes.phaseOffset.data(), juce::MathConstants<float>::twoPi, MAX_LANES);
+}
+
 float MicroPitchDetune::lfo(float phase)
 {
     // Smooth sine wave
@@ -142,22 +295,23 @@ float MicroPitchDetune::centsToDelayOffset(float cents, float baseDelay)
 
 void MicroPitchDetune::updateTapOffsets()
 {
-    // Configure multi-tap delays with diffusion
-    // Tap 0: Center (main delay)
-    // Tap 1: Slightly earlier with different phase
-    // Tap 2: Slightly later with different phase
+    // Configure multi-voice delays with diffusion: voices are spread evenly
+    // either side of the main delay, each with a different phase
+
+    const float centreVoice = 0.5f * static_cast<float>(numVoices - 1);
 
-    for (int i = 0; i < NUM_TAPS; ++i)
+    for (int i = 0; i < numVoices; ++i)
     {
-        float tapOffset = (i - 1.0f) * 0.002f * diffusion;  // 2ms max spread
-        tapsL[i].timeOffset = tapOffset;
-        tapsR[i].timeOffset = tapOffset * 1.1f;  // Slightly different for L/R
+        float spread = numVoices > 1 ? (static_cast<float>(i) - centreVoice) / centreVoice : 0.0f;
+        float tapOffset = spread * 0.002f * diffusion;  // 2ms max spread
+        lanes.timeOffset[static_cast<size_t>(i)] = tapOffset;
+        lanes.timeOffset[static_cast<size_t>(MAX_VOICES + i)] = tapOffset * 1.1f;  // Slightly different for L/R
     }
 }
 
 void MicroPitchDetune::process(juce::dsp::AudioBlock<float>& block)
 {
-    auto numSamples = block.getNumSamples();
+    auto numSamples = static_cast<int>(block.getNumSamples());
     auto numChannels = block.getNumChannels();
 
     if (numChannels == 0 || numSamples == 0)
@@ -171,78 +325,323 @@ void MicroPitchDetune::process(juce::dsp::AudioBlock<float>& block)
         rate = beatsPerSecond * lfoRate;
     }
 
-    // Calculate pitch-based delay offset
-    float detuneOffset = centsToDelayOffset(detuneCents, delayCentre);
+    // Equal-power dry/wet gains, constant across the block
+    const float wetGain = std::sin(mix * juce::MathConstants<float>::halfPi);
+    const float dryGain = std::cos(mix * juce::MathConstants<float>::halfPi);
 
-    for (size_t i = 0; i < numSamples; ++i)
+    float* left = block.getChannelPointer(0);
+    float* right = numChannels > 1 ? block.getChannelPointer(1) : nullptr;
+
+    const int maxChunk = static_cast<int>(wetBufferL.size());
+    for (int start = 0; start < numSamples; start += maxChunk)
     {
-        // Process each channel
-        for (size_t ch = 0; ch < numChannels; ++ch)
+        const int chunk = juce::jmin(maxChunk, numSamples - start);
+        float* chunkL = left + start;
+        float* chunkR = right != nullptr ? right + start : nullptr;
+
+        // A mono input drives the right voices too; their output is discarded
+        const float* voiceInR = chunkR != nullptr ? chunkR : chunkL;
+        if (engine == Engine::Granular)
+            processGrains(chunkL, chunkR, chunk);
+#if ECHOPSYCHFX_TESTS
+        else if (useReferenceKernel)
+            processVoicesReference(chunkL, voiceInR, chunk, rate);
+#endif
+        else
+            (this->*voiceKernel)(chunkL, voiceInR, chunk, rate);
+
+        juce::FloatVectorOperations::multiply(chunkL, dryGain, chunk);
+        juce::FloatVectorOperations::addWithMultiply(chunkL, wetBufferL.data(), wetGain, chunk);
+
+        if (chunkR != nullptr)
         {
-            float inSample = block.getSample(static_cast<int>(ch), static_cast<int>(i));
-            float wetSample = 0.0f;
+            juce::FloatVectorOperations::multiply(chunkR, dryGain, chunk);
+            juce::FloatVectorOperations::addWithMultiply(chunkR, wetBufferR.data(), wetGain, chunk);
+        }
+    }
+}
+
+template <int NumVoices>
+void MicroPitchDetune::processVoices(const float* inL, const float* inR, int numSamples, float rate)
+{
+    constexpr double twoPi = juce::MathConstants<double>::twoPi;
+    constexpr float voiceGain = 1.0f / static_cast<float>(NumVoices);
+    constexpr size_t stride = 2 * NumVoices;
+
+    // Per-voice base delay and clamp range, in samples
+    const float detuneOffset = centsToDelayOffset(detuneCents, delayCentre);
+    const float minDelay = 0.001f * sampleRate;
+    const float maxDelay = maxDelayTime * sampleRate;
+    const float depth = lfoDepth * sampleRate;
+
+    std::array<float, MAX_LANES> baseDelay;
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const float channelDetuneOffset = ch == 0 ? detuneOffset : -detuneOffset;
+        const float channelStereoPhase = ch == 0 ? 0.0f : stereoSeparation;
+
+        for (int v = 0; v < NumVoices; ++v)
+        {
+            const auto l = static_cast<size_t>(ch * MAX_VOICES + v);
+            baseDelay[l] = (delayCentre + channelDetuneOffset + lanes.timeOffset[l]) * sampleRate;
+
+            // Start each voice's LFO phasor at the exact phase for this chunk,
+            // then rotate it per sample instead of calling sin() per voice.
+            // Voices are spread evenly in phase.
+            const double voicePhase = static_cast<double>(modPhase) + channelStereoPhase
+                + static_cast<double>(v) / NumVoices;
+            const double theta = voicePhase * twoPi + lanes.phaseOffset[l];
+            lanes.lfoSin[l] = std::sin(theta);
+            lanes.lfoCos[l] = std::cos(theta);
+        }
+    }
+
+    const float phaseIncrement = rate / sampleRate;
+    const double rotSin = std::sin(twoPi * phaseIncrement);
+    const double rotCos = std::cos(twoPi * phaseIncrement);
+
+    float* const history = ring.data();
+    const bool useFeedback = feedback > 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        std::array<float, MAX_LANES> modulation;
+        std::array<float, MAX_LANES> voiceOut;
+        float* const slot = history + static_cast<size_t>(writePos) * stride;
+        const float channelIn[2] = { inL[i], inR[i] };
+        float channelSum[2] = { 0.0f, 0.0f };
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const size_t first = static_cast<size_t>(ch * MAX_VOICES);
+
+            for (size_t l = first; l < first + NumVoices; ++l)
+            {
+                modulation[l] = static_cast<float>(lanes.lfoSin[l]);
 
-            // Determine if left or right processing
-            bool isLeft = (ch % 2 == 0);
-            auto& taps = isLeft ? tapsL : tapsR;
-            auto& dcBlocker = isLeft ? dcBlockerL : dcBlockerR;
+                const double s = lanes.lfoSin[l];
+                const double c = lanes.lfoCos[l];
+                lanes.lfoSin[l] = s * rotCos + c * rotSin;
+                lanes.lfoCos[l] = c * rotCos - s * rotSin;
+            }
 
-            float channelDetuneOffset = isLeft ? detuneOffset : -detuneOffset;
-            float channelStereoPhase = isLeft ? 0.0f : stereoSeparation;
+            // Anti-alias the modulation
+            for (size_t l = first; l < first + NumVoices; ++l)
+            {
+                lanes.modulation[l] += (modulation[l] - lanes.modulation[l]) * modulationSmoothingCoeff;
+                modulation[l] = lanes.modulation[l];
+            }
 
-            // Process each tap and sum the results
-            for (int tapIdx = 0; tapIdx < NUM_TAPS; ++tapIdx)
+            // Calculate delay time with all modulations
+            for (size_t l = first; l < first + NumVoices; ++l)
             {
-                auto& tap = taps[tapIdx];
+                const float target = juce::jlimit(minDelay, maxDelay, baseDelay[l] + modulation[l] * depth);
+                lanes.smoothedDelay[l] += (static_cast<double>(target) - lanes.smoothedDelay[l]) * delaySmoothingCoeff;
+            }
 
-                // Calculate LFO modulation for this tap
-                float tapPhase = modPhase + channelStereoPhase + (tapIdx * 0.333f);  // Spread taps in phase
-                float lfoValue = lfo(tapPhase * juce::MathConstants<float>::twoPi + tap.phaseOffset);
+            // Third-order Lagrange read per voice, matching
+            // DelayLineInterpolationTypes::Lagrange3rd read before the write
+            for (int v = 0; v < NumVoices; ++v)
+            {
+                const size_t l = first + static_cast<size_t>(v);
+                const size_t column = static_cast<size_t>(ch * NumVoices + v);
+                const auto d = static_cast<float>(lanes.smoothedDelay[l]);
+                const int delayInt = static_cast<int>(d) - 1;
+                const float frac = d - static_cast<float>(delayInt);
+
+                const int newest = writePos - delayInt;
+                const float v1 = history[static_cast<size_t>(newest & ringMask) * stride + column];
+                const float v2 = history[static_cast<size_t>((newest - 1) & ringMask) * stride + column];
+                const float v3 = history[static_cast<size_t>((newest - 2) & ringMask) * stride + column];
+                const float v4 = history[static_cast<size_t>((newest - 3) & ringMask) * stride + column];
+
+                const float d1 = frac - 1.0f;
+                const float d2 = frac - 2.0f;
+                const float d3 = frac - 3.0f;
+
+                const float c1 = -d1 * d2 * d3 * (1.0f / 6.0f);
+                const float c2 = d2 * d3 * 0.5f;
+                const float c3 = -d1 * d3 * 0.5f;
+                const float c4 = d1 * d2 * (1.0f / 6.0f);
+
+                voiceOut[l] = v1 * c1 + frac * (v2 * c2 + v3 * c3 + v4 * c4);
+            }
 
-                // Anti-alias the modulation
-                modulationSmoother.setTargetValue(lfoValue);
-                float smoothedLfo = modulationSmoother.getNextValue();
+            // Apply DC blocking to feedback path
+            if (useFeedback)
+            {
+                for (size_t l = first; l < first + NumVoices; ++l)
+                {
+                    const double x = voiceOut[l];
+                    const double y = dcCoefficients[0] * x + lanes.dcState1[l];
+                    lanes.dcState1[l] = dcCoefficients[1] * x - dcCoefficients[4] * y + lanes.dcState2[l];
+                    lanes.dcState2[l] = dcCoefficients[2] * x - dcCoefficients[5] * y;
+                    lanes.feedback[l] = static_cast<float>(y);
+                }
+            }
+
+            // Write to delay line with feedback, and accumulate the voices
+            // (with gain compensation for multiple voices)
+            for (int v = 0; v < NumVoices; ++v)
+            {
+                const size_t l = first + static_cast<size_t>(v);
+                slot[ch * NumVoices + v] = channelIn[ch] + lanes.feedback[l] * feedback;
+                channelSum[ch] += voiceOut[l];
+            }
+        }
 
-                // Calculate delay time with all modulations
-                float delayTime = delayCentre + channelDetuneOffset + tap.timeOffset + smoothedLfo * lfoDepth;
-                delayTime = juce::jlimit(0.001f, maxDelayTime, delayTime);
+        writePos = (writePos + 1) & ringMask;
 
-                tap.smoothedDelay.setTargetValue(delayTime * sampleRate);
-                tap.delay.setDelay(tap.smoothedDelay.getNextValue());
+        wetBufferL[static_cast<size_t>(i)] = channelSum[0] * voiceGain;
+        wetBufferR[static_cast<size_t>(i)] = channelSum[1] * voiceGain;
+    }
 
-                // Read from delay line
-                float tapSample = tap.delay.popSample(0);
+    if (!useFeedback)
+        lanes.feedback.fill(0.0f);
 
-                // Apply DC blocking to feedback path
-                if (feedback > 0.0f)
+    // Advance LFO phase
+    modPhase += phaseIncrement * static_cast<float>(numSamples);
+    modPhase -= std::floor(modPhase);
+}
+
+#if ECHOPSYCHFX_TESTS
+void MicroPitchDetune::processVoicesReference(const float* inL, const float* inR, int numSamples, float rate)
+{
+    // Straightforward sample -> channel -> voice version of processVoices(),
+    // with sin() per voice and no phasors. Shares all state with the
+    // kernels, so the two can be nulled against each other.
+    constexpr double twoPi = juce::MathConstants<double>::twoPi;
+    const float voiceGain = 1.0f / static_cast<float>(numVoices);
+    const int stride = 2 * numVoices;
+
+    const float detuneOffset = centsToDelayOffset(detuneCents, delayCentre);
+    const float phaseIncrement = rate / sampleRate;
+    const bool useFeedback = feedback > 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double samplePhase = modPhase + static_cast<double>(phaseIncrement) * i;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const float inSample = ch == 0 ? inL[i] : inR[i];
+            const float channelDetuneOffset = ch == 0 ? detuneOffset : -detuneOffset;
+            const float channelStereoPhase = ch == 0 ? 0.0f : stereoSeparation;
+            float wetSample = 0.0f;
+
+            for (int v = 0; v < numVoices; ++v)
+            {
+                const auto l = static_cast<size_t>(ch * MAX_VOICES + v);
+                const int column = ch * numVoices + v;
+
+                const double voicePhase = samplePhase + channelStereoPhase
+                    + static_cast<double>(v) / numVoices;
+                const auto lfoValue = static_cast<float>(std::sin(voicePhase * twoPi + lanes.phaseOffset[l]));
+
+                lanes.modulation[l] += (lfoValue - lanes.modulation[l]) * modulationSmoothingCoeff;
+
+                const float baseDelay = (delayCentre + channelDetuneOffset + lanes.timeOffset[l]) * sampleRate;
+                const float target = juce::jlimit(0.001f * sampleRate, maxDelayTime * sampleRate,
+                    baseDelay + lanes.modulation[l] * lfoDepth * sampleRate);
+                lanes.smoothedDelay[l] += (static_cast<double>(target) - lanes.smoothedDelay[l]) * delaySmoothingCoeff;
+
+                // Lagrange through the four samples around the read point
+                const auto d = static_cast<float>(lanes.smoothedDelay[l]);
+                const int delayInt = static_cast<int>(d) - 1;
+                const float frac = d - static_cast<float>(delayInt);
+
+                float points[4];
+                for (int k = 0; k < 4; ++k)
+                    points[k] = ring[static_cast<size_t>(((writePos - delayInt - k) & ringMask) * stride + column)];
+
+                float voiceSample = 0.0f;
+                for (int k = 0; k < 4; ++k)
+                {
+                    float weight = 1.0f;
+                    for (int m = 0; m < 4; ++m)
+                        if (m != k)
+                            weight *= (frac - static_cast<float>(m)) / static_cast<float>(k - m);
+                    voiceSample += points[k] * weight;
+                }
+
+                if (useFeedback)
                 {
-                    tap.feedback = dcBlocker.processSample(tapSample);
+                    const double x = voiceSample;
+                    const double y = dcCoefficients[0] * x + lanes.dcState1[l];
+                    lanes.dcState1[l] = dcCoefficients[1] * x - dcCoefficients[4] * y + lanes.dcState2[l];
+                    lanes.dcState2[l] = dcCoefficients[2] * x - dcCoefficients[5] * y;
+                    lanes.feedback[l] = static_cast<float>(y);
                 }
                 else
                 {
-                    tap.feedback = 0.0f;
+                    lanes.feedback[l] = 0.0f;
                 }
 
-                // Write to delay line with feedback
-                tap.delay.pushSample(0, inSample + tap.feedback * feedback);
-
-                // Accumulate tap output (with gain compensation for multiple taps)
-                float tapGain = 1.0f / static_cast<float>(NUM_TAPS);
-                wetSample += tapSample * tapGain;
+                ring[static_cast<size_t>(writePos * stride + column)] = inSample + lanes.feedback[l] * feedback;
+                wetSample += voiceSample * voiceGain;
             }
 
-            // Mix dry and wet signals with equal-power crossfade
-            float wetGain = std::sin(mix * juce::MathConstants<float>::halfPi);
-            float dryGain = std::cos(mix * juce::MathConstants<float>::halfPi);
-            float finalSample = inSample * dryGain + wetSample * wetGain;
+            (ch == 0 ? wetBufferL : wetBufferR)[static_cast<size_t>(i)] = wetSample;
+        }
+
+        writePos = (writePos + 1) & ringMask;
+    }
+
+    modPhase += phaseIncrement * static_cast<float>(numSamples);
+    modPhase -= std::floor(modPhase);
+}
+#endif
+
+void MicroPitchDetune::processGrains(float* left, float* right, int numSamples)
+{
+    // Two read heads per channel sweep the delay at (1 - ratio) samples per
+    // sample, half a grain apart; each fades in and out over its sweep so the
+    // jump back to the start of the grain is silent. The dry signal is delayed
+    // by the reported latency so it stays aligned with the wet one.
+    const int latency = getLatencySamples();
+    const float ratio = std::pow(2.0f, detuneCents / 1200.0f);
+    const std::array<float, 2> phaseIncrement = { (1.0f - ratio) / grainSamples,
+                                                  (1.0f - 1.0f / ratio) / grainSamples };
+    const float* window = windowTable.data();
+
+    // A mono block only needs the left shifter
+    const int numChannels = right != nullptr ? 2 : 1;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* io = ch == 0 ? left : right;
+        float* ring = ch == 0 ? grainRingL.data() : grainRingR.data();
+        float* wet = ch == 0 ? wetBufferL.data() : wetBufferR.data();
+        float phase = grainPhase[static_cast<size_t>(ch)];
+        int pos = grainWritePos;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            ring[pos] = io[i];
+
+            float phaseB = phase + 0.5f;
+            phaseB -= phaseB >= 1.0f ? 1.0f : 0.0f;
 
-            block.setSample(static_cast<int>(ch), static_cast<int>(i), finalSample);
+            // Linear lookup in the window table
+            const float indexA = phase * windowTableSize;
+            const int iA = juce::jmin(static_cast<int>(indexA), windowTableSize - 1);
+            const float gainA = window[iA] + (indexA - static_cast<float>(iA)) * (window[iA + 1] - window[iA]);
+
+            const float headA = readLagrange3(ring, grainRingMask, pos, grainMinDelay + phase * grainSamples);
+            const float headB = readLagrange3(ring, grainRingMask, pos, grainMinDelay + phaseB * grainSamples);
+            wet[i] = headA * gainA + headB * (1.0f - gainA);
+
+            io[i] = ring[(pos - latency) & grainRingMask];
+
+            phase += phaseIncrement[static_cast<size_t>(ch)];
+            phase -= std::floor(phase);
+            pos = (pos + 1) & grainRingMask;
         }
 
-        // Advance LFO phase
-        modPhase += rate / sampleRate;
-        modPhase = std::fmod(modPhase, 1.0f);
+        grainPhase[static_cast<size_t>(ch)] = phase;
     }
+
+    grainWritePos = (grainWritePos + numSamples) & grainRingMask;
 }
 
 void MicroPitchDetune::loadPreset(const Preset& preset)
@@ -251,24 +650,25 @@ void MicroPitchDetune::loadPreset(const Preset& preset)
         preset.delayCentre, preset.stereoSeparation, preset.mix,
         preset.feedback, preset.diffusion);
     setSyncEnabled(preset.syncEnabled);
+    setNumVoices(preset.numVoices);
 }
 
 MicroPitchDetune::Preset MicroPitchDetune::getCurrentPreset() const
 {
     return Preset("Current", detuneCents, lfoRate, lfoDepth, delayCentre,
-        stereoSeparation, mix, feedback, diffusion, syncEnabled);
+        stereoSeparation, mix, feedback, diffusion, syncEnabled, numVoices);
 }
 
 std::vector<MicroPitchDetune::Preset> MicroPitchDetune::getFactoryPresets()
 {
     return {
-        Preset("Subtle Detune", 5.0f, 0.1f, 0.0f, 0.005f, 0.3f, 0.3f, 0.0f, 0.0f, false),
+        Preset("Subtle Detune", 5.0f, 0.1f, 0.0f, 0.005f, 0.3f, 0.3f, 0.0f, 0.0f, false, 1),
         Preset("Wide Chorus", 12.0f, 0.5f, 0.003f, 0.008f, 0.7f, 0.5f, 0.2f, 0.3f, false),
         Preset("Shimmer", 8.0f, 0.2f, 0.004f, 0.010f, 0.5f, 0.4f, 0.3f, 0.6f, false),
         Preset("Flanger-ish", 15.0f, 0.3f, 0.006f, 0.003f, 0.4f, 0.5f, 0.4f, 0.2f, false),
         Preset("Deep Space", 20.0f, 0.08f, 0.005f, 0.012f, 0.9f, 0.6f, 0.5f, 0.8f, false),
         Preset("Synced Vibrato", 10.0f, 1.0f, 0.004f, 0.006f, 0.5f, 0.7f, 0.1f, 0.0f, true),
-        Preset("Lush Ensemble", 7.0f, 0.15f, 0.003f, 0.007f, 0.6f, 0.45f, 0.25f, 0.5f, false),
-        Preset("Micro Shift", 3.0f, 0.05f, 0.001f, 0.004f, 0.2f, 0.25f, 0.0f, 0.0f, false)
+        Preset("Lush Ensemble", 7.0f, 0.15f, 0.003f, 0.007f, 0.6f, 0.45f, 0.25f, 0.5f, false, 8),
+        Preset("Micro Shift", 3.0f, 0.05f, 0.001f, 0.004f, 0.2f, 0.25f, 0.0f, 0.0f, false, 1)
     };
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
-#include <random>
+#include "DeterministicRandom.h"
 #include <array>
+#include <vector>
 
 class MicroPitchDetune
 {
@@ -19,16 +20,28 @@ public:
         float feedback;
         float diffusion;
         bool syncEnabled;
+        int numVoices;
 
         Preset(const juce::String& n = "Default", float dc = 5.0f, float lr = 0.1f,
             float ld = 0.002f, float del = 0.005f, float ss = 0.5f,
-            float m = 0.5f, float fb = 0.0f, float diff = 0.0f, bool sync = false)
+            float m = 0.5f, float fb = 0.0f, float diff = 0.0f, bool sync = false,
+            int voices = 3)
             : name(n), detuneCents(dc), lfoRate(lr), lfoDepth(ld),
             delayCentre(del), stereoSeparation(ss), mix(m),
-            feedback(fb), diffusion(diff), syncEnabled(sync) {
+            feedback(fb), diffusion(diff), syncEnabled(sync), numVoices(voices) {
         }
     };
 
+    // Modulated: LFO-swept multi-voice delays (chorus-like detune)
+    // Granular: dual-grain pitch shifter for true static shifts, with latency
+    enum class Engine
+    {
+        Modulated,
+        Granular
+    };
+
+    static constexpr int MAX_VOICES = 8;  // Per channel
+
     MicroPitchDetune();
     ~MicroPitchDetune() = default;
 
@@ -39,7 +52,17 @@ public:
         float delayCentreIn, float stereoSeparationIn, float mixIn,
         float feedbackIn = 0.0f, float diffusionIn = 0.0f);
     void setSyncEnabled(bool shouldSync);
+    void setNumVoices(int newNumVoices);  // 1 to MAX_VOICES per channel
+#if ECHOPSYCHFX_TESTS  // Only the EchoPsychFXTests target builds the reference kernel
+    void setUseReferenceKernel(bool shouldUse);  // Plain per-sample path, for null tests
+#endif
+    void setEngine(Engine newEngine);
+    Engine getEngine() const { return engine; }
+    int getLatencySamples() const;  // Non-zero only for the granular engine
+    int getNumVoices() const { return numVoices; }
     void setBpm(float newBpm);
+    void setPpqPosition(double ppqPosition); // Locks the synced LFO phase to the host
+    void setSeed(juce::uint64 newSeed); // Re-draws the tap LFO phase offsets
 
     void process(juce::dsp::AudioBlock<float>& block);
 
@@ -49,27 +72,73 @@ public:
     static std::vector<Preset> getFactoryPresets();
 
 private:
-    // Multi-tap delay structure for richer sound
-    static constexpr int NUM_TAPS = 3;
+    // Multi-voice delay structure for richer sound
+    static constexpr int MAX_LANES = 2 * MAX_VOICES;
 
-    struct DelayTap
+    // Voice state in structure-of-arrays form. Lane ch * MAX_VOICES + v holds
+    // voice v of channel ch, so the per-sample loops run across every voice
+    struct VoiceLanes
     {
-        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> delay;
-        juce::SmoothedValue<float> smoothedDelay;
-        float feedback = 0.0f;
-        float timeOffset = 0.0f;  // Offset from base delay time
-        float phaseOffset = 0.0f;  // LFO phase offset
+        std::array<float, MAX_LANES> timeOffset {};     // Offset from base delay time (s)
+        std::array<float, MAX_LANES> phaseOffset {};    // LFO phase offset (rad)
+        std::array<float, MAX_LANES> modulation {};     // Smoothed LFO value
+        std::array<float, MAX_LANES> feedback {};
+
+        // Kept in double: a float one-pole stalls short of its target, the
+        // DC blocker's poles sit so close to z = 1 that float state is noisy,
+        // and a float phasor drifts by parts per million over a block
+        std::array<double, MAX_LANES> smoothedDelay {}; // Current delay (samples)
+        std::array<double, MAX_LANES> dcState1 {};      // DC blocker, transposed direct form II
+        std::array<double, MAX_LANES> dcState2 {};
+        std::array<double, MAX_LANES> lfoSin {};        // LFO phasor, rotated per sample
+        std::array<double, MAX_LANES> lfoCos {};
     };
 
-    std::array<DelayTap, NUM_TAPS> tapsL;
-    std::array<DelayTap, NUM_TAPS> tapsR;
-
-    // DC blocking filters for feedback paths
-    juce::dsp::IIR::Filter<float> dcBlockerL;
-    juce::dsp::IIR::Filter<float> dcBlockerR;
+    VoiceLanes lanes;
+    int numVoices = 3;
+
+    // Delay history for the active voices, interleaved as [position][channel][voice]
+    // so each sample's writes are contiguous. The spare copy is used to re-lay
+    // the history out when the voice count changes.
+    std::vector<float> ring;
+    std::vector<float> ringSpare;
+    int ringMask = 0;
+    int writePos = 0;
+
+    // Block kernels specialised per voice count, indexed by numVoices - 1
+    using VoiceKernel = void (MicroPitchDetune::*)(const float*, const float*, int, float);
+    static const std::array<VoiceKernel, MAX_VOICES> voiceKernels;
+    VoiceKernel voiceKernel;
+
+    // Granular engine: per-channel history, a grain phasor per channel, and
+    // a sin^2 window table so two grains half a period apart sum to one
+    static constexpr float grainTime = 0.02f;  // Seconds per grain
+    static constexpr int windowTableSize = 512;
+
+    Engine engine = Engine::Modulated;
+    std::vector<float> grainRingL;
+    std::vector<float> grainRingR;
+    std::vector<float> windowTable;  // windowTableSize + 1 points over one grain
+    int grainRingMask = 0;
+    int grainWritePos = 0;
+    float grainSamples = 0.0f;
+    float grainMinDelay = 4.0f;  // Keeps the interpolator clear of the write head
+    std::array<float, 2> grainPhase {};
+
+    // Wet sums per channel for the current chunk
+    std::vector<float> wetBufferL;
+    std::vector<float> wetBufferR;
+
+    double delaySmoothingCoeff = 0.0;
+#if ECHOPSYCHFX_TESTS
+    bool useReferenceKernel = false;
+#endif
+
+    // DC blocking high-pass for the feedback paths, { b0, b1, b2, a0, a1, a2 }
+    std::array<double, 6> dcCoefficients {};
 
     // One-pole lowpass for anti-aliasing modulation
-    juce::SmoothedValue<float> modulationSmoother;
+    float modulationSmoothingCoeff = 0.0f;
 
     float sampleRate = 44100.0f;
     float detuneCents = 5.0f;
@@ -87,14 +156,23 @@ private:
     bool syncEnabled = false;
     float bpm = 120.0f;
 
-    std::mt19937 randomEngine;
-    std::uniform_real_distribution<float> randomDistribution;
+    DeterministicRandom random;
 
     // Improved LFO with multiple shapes
     float lfo(float phase);
     float lfoTriangle(float phase);
     float centsToDelayOffset(float cents, float baseDelay);
     void updateTapOffsets();
+    void randomiseTapPhases();
+    void relayoutVoices(int oldNumVoices);
+
+    template <int NumVoices>
+    void processVoices(const float* inL, const float* inR, int numSamples, float rate);
+#if ECHOPSYCHFX_TESTS
+    void processVoicesReference(const float* inL, const float* inR, int numSamples, float rate);
+#endif
+    void processGrains(float* left, float* right, int numSamples);
+    void resetGrains();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MicroPitchDetune)
 };
\ No newline at end of file
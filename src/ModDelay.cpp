@@ -5,13 +5,28 @@
 void ModDelay::prepare(const juce::dsp::ProcessSpec& spec) {
     sampleRate = static_cast<float>(spec.sampleRate);
 
-    constexpr size_t maxDelaySamples = 44100;
-    delayL.reset();
-    delayR.reset();
-    delayL.setMaximumDelayInSamples(maxDelaySamples);
-    delayR.setMaximumDelayInSamples(maxDelaySamples);
-    delayL.prepare(spec);
-    delayR.prepare(spec);
+    // Longest read is the maximum delay plus full depth, plus the three
+    // older Lagrange points
+    const int maxDelaySamples = static_cast<int>(std::ceil((maxDelayMs + maxDepthMs) * 0.001f * sampleRate)) + 4;
+    const int ringSize = juce::nextPowerOfTwo(maxDelaySamples);
+    ringMask = ringSize - 1;
+    ringL.assign(static_cast<size_t>(ringSize), 0.0f);
+    ringR.assign(static_cast<size_t>(ringSize), 0.0f);
+
+    // The newest Lagrange point sits one sample inside the minimum delay
+    const int minDelaySamples = static_cast<int>(minDelayMs * 0.001f * sampleRate);
+    maxChunkSize = juce::jlimit(1, juce::jmax(1, static_cast<int>(spec.maximumBlockSize)), minDelaySamples - 2);
+
+    for (auto* buffer : { &phaseBuffer, &modBuffer, &modScratch, &delayBufferL, &delayBufferR,
+                          &wetBufferL, &wetBufferR, &tapReadL, &tapReadR, &tapWetL, &tapWetR,
+                          &feedbackBufferL, &feedbackBufferR })
+        buffer->assign(static_cast<size_t>(maxChunkSize), 0.0f);
+
+    for (auto& tap : taps)
+        for (auto* smoother : { &tap.timeMs, &tap.modDepthMs, &tap.gainL, &tap.gainR, &tap.send })
+            smoother->reset(sampleRate, 0.05);
+
+    updateLoopFilter();
 
     modulationTypeCrossfade.reset(sampleRate, 0.02);
     modulationTypeCrossfade.setCurrentAndTargetValue(0.0f);
@@ -20,23 +35,162 @@ void ModDelay::prepare(const juce::dsp::ProcessSpec& spec) {
 }
 
 void ModDelay::resetState() {
+    std::fill(ringL.begin(), ringL.end(), 0.0f);
+    std::fill(ringR.begin(), ringR.end(), 0.0f);
+    writePos = 0;
+    highCutState.fill(0.0f);
+    lowCutState.fill(0.0f);
+
     phase = 0.0f;
     currentModulationType = ModulationType::Sine;
     targetModulationType = ModulationType::Sine;
     modulationTypeCrossfade.setCurrentAndTargetValue(0.0f);
     params.reset(sampleRate, 0.05);
+    updateFeedbackMatrix();
+
+    for (auto& tap : taps) {
+        tap.timeMs.setCurrentAndTargetValue(tap.timeMs.getTargetValue());
+        tap.modDepthMs.setCurrentAndTargetValue(tap.modDepthMs.getTargetValue());
+        tap.gainL.setCurrentAndTargetValue(tap.gainL.getTargetValue());
+        tap.gainR.setCurrentAndTargetValue(tap.gainR.getTargetValue());
+        tap.send.setCurrentAndTargetValue(tap.send.getTargetValue());
+    }
 }
 
 void ModDelay::setParams(float dMs, float depth, float rate, float fbL, float fbR, float m) {
-    params.delayMs.setTargetValue(dMs);
-    params.modDepth.setTargetValue(depth);
+    rawDelayMs = dMs;
+    updateEffectiveDelay();
+    params.modDepth.setTargetValue(juce::jlimit(0.0f, maxDepthMs, depth));
     rawRate = rate;
     updateEffectiveRate();
-    params.feedbackL.setTargetValue(juce::jlimit(0.0f, 0.95f, fbL));
-    params.feedbackR.setTargetValue(juce::jlimit(0.0f, 0.95f, fbR));
+    feedbackGainL = juce::jlimit(0.0f, 0.95f, fbL);
+    feedbackGainR = juce::jlimit(0.0f, 0.95f, fbR);
+    loopGainsChanged = true;
     params.mix.setTargetValue(juce::jlimit(0.0f, 1.0f, m));
 }
 
+void ModDelay::setFeedbackMode(FeedbackMode newMode) {
+    feedbackMode = newMode;
+    loopGainsChanged = true;
+}
+
+void ModDelay::setFeedbackFilter(float newLowCutHz, float newHighCutHz) {
+    if (newLowCutHz == lowCutHz && newHighCutHz == highCutHz)
+        return;
+
+    lowCutHz = newLowCutHz;
+    highCutHz = newHighCutHz;
+    updateLoopFilter();
+}
+
+void ModDelay::updateFeedbackMatrix() {
+    // Targets for [L; R]_in += M [L; R]_wet, plus the tap sends. Every mode
+    // keeps the matrix gain at or below max(feedbackL, feedbackR), and the
+    // loop filters never boost, so the loop gain is at most that plus the
+    // sum of the sends. When that exceeds maxLoopGain, the matrix and the
+    // sends are scaled down together.
+    float totalGain = juce::jmax(feedbackGainL, feedbackGainR);
+    for (int t = 0; t < numTaps; ++t)
+        totalGain += taps[static_cast<size_t>(t)].requestedSend;
+
+    const float loopScale = totalGain > maxLoopGain ? maxLoopGain / totalGain : 1.0f;
+
+    for (auto& tap : taps)
+        tap.send.setTargetValue(tap.requestedSend * loopScale);
+
+    loopGainsChanged = false;
+
+    const float a = feedbackGainL * loopScale;
+    const float b = feedbackGainR * loopScale;
+    float lFromL = a, lFromR = 0.0f, rFromL = 0.0f, rFromR = b;
+
+    switch (feedbackMode) {
+    case FeedbackMode::PingPong:
+        lFromL = 0.0f; lFromR = b;
+        rFromL = a;    rFromR = 0.0f;
+        break;
+    case FeedbackMode::Cross: {
+        const float c = juce::MathConstants<float>::sqrt2 * 0.5f;
+        lFromL = c * a; lFromR = -c * b;
+        rFromL = c * a; rFromR = c * b;
+        break;
+    }
+    case FeedbackMode::MidSide:
+        // a scales mid, b scales side
+        lFromL = 0.5f * (a + b); lFromR = 0.5f * (a - b);
+        rFromL = 0.5f * (a - b); rFromR = 0.5f * (a + b);
+        break;
+    case FeedbackMode::Independent:
+    default:
+        break;
+    }
+
+    params.feedbackLFromL.setTargetValue(lFromL);
+    params.feedbackLFromR.setTargetValue(lFromR);
+    params.feedbackRFromL.setTargetValue(rFromL);
+    params.feedbackRFromR.setTargetValue(rFromR);
+}
+
+void ModDelay::updateLoopFilter() {
+    // Outside 20 Hz - 20 kHz the loop is left unfiltered
+    const float nyquistLimit = sampleRate * 0.45f;
+    const bool lowCutActive = lowCutHz > 20.0f;
+    const bool highCutActive = highCutHz < juce::jmin(20000.0f, nyquistLimit);
+
+    lowCutPole = lowCutActive
+        ? std::exp(-juce::MathConstants<float>::twoPi * juce::jmin(lowCutHz, nyquistLimit) / sampleRate) : 1.0f;
+    highCutPole = highCutActive
+        ? std::exp(-juce::MathConstants<float>::twoPi * juce::jmax(highCutHz, 20.0f) / sampleRate) : 0.0f;
+
+    // Filters start from silence when switched in
+    if (!loopFilterEnabled && (lowCutActive || highCutActive)) {
+        highCutState.fill(0.0f);
+        lowCutState.fill(0.0f);
+    }
+
+    loopFilterEnabled = lowCutActive || highCutActive;
+}
+
+void ModDelay::setTap(int index, const TapSettings& settings) {
+    if (!juce::isPositiveAndBelow(index, maxTaps))
+        return;
+
+    auto& tap = taps[static_cast<size_t>(index)];
+    const float gain = juce::jlimit(0.0f, 1.0f, settings.gain);
+    const float angle = (juce::jlimit(-1.0f, 1.0f, settings.pan) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+
+    tap.timeMs.setTargetValue(juce::jlimit(minDelayMs, maxDelayMs, settings.timeMs));
+    tap.modDepthMs.setTargetValue(juce::jlimit(0.0f, maxDepthMs, settings.modDepthMs));
+    tap.gainL.setTargetValue(gain * std::cos(angle));
+    tap.gainR.setTargetValue(gain * std::sin(angle));
+    const float requestedSend = gain * juce::jlimit(0.0f, 0.95f, settings.feedback);
+    if (requestedSend != tap.requestedSend) {
+        tap.requestedSend = requestedSend;
+        loopGainsChanged = true;
+    }
+}
+
+void ModDelay::setNumTaps(int newNumTaps) {
+    const int clamped = juce::jlimit(0, maxTaps, newNumTaps);
+
+    // Newly enabled taps fade in from silence
+    for (int i = numTaps; i < clamped; ++i) {
+        auto& tap = taps[static_cast<size_t>(i)];
+        tap.timeMs.setCurrentAndTargetValue(tap.timeMs.getTargetValue());
+        tap.modDepthMs.setCurrentAndTargetValue(tap.modDepthMs.getTargetValue());
+        for (auto* gain : { &tap.gainL, &tap.gainR, &tap.send }) {
+            const float target = gain->getTargetValue();
+            gain->setCurrentAndTargetValue(0.0f);
+            gain->setTargetValue(target);
+        }
+    }
+
+    if (clamped != numTaps)
+        loopGainsChanged = true;
+
+    numTaps = clamped;
+}
+
 void ModDelay::process(juce::dsp::AudioBlock<float>& block) {
     // Safety check for stereo
     if (block.getNumChannels() < 2)
@@ -46,62 +200,324 @@ void ModDelay::process(juce::dsp::AudioBlock<float>& block) {
     auto* right = block.getChannelPointer(1);
     const int numSamples = static_cast<int>(block.getNumSamples());
 
-    float invSampleRate = 1.0f / sampleRate;
-    float crossfade = 0.0f;
+    // Setters only flag a change, so a block's worth of tap updates moves
+    // each smoothed target once
+    if (loopGainsChanged)
+        updateFeedbackMatrix();
+
+    for (int start = 0; start < numSamples; start += maxChunkSize) {
+        const int chunk = juce::jmin(maxChunkSize, numSamples - start);
+        processChunk(left + start, right + start, chunk);
+    }
+}
+
+void ModDelay::processChunk(float* left, float* right, int numSamples) {
+    // 1. Modulation shape, crossfading between types while a change is pending
+    renderPhase(numSamples);
+    auto* mod = modBuffer.data();
+
+    if (currentModulationType == targetModulationType && !modulationTypeCrossfade.isSmoothing()) {
+        modulationTypeCrossfade.skip(numSamples);
+        renderModulationShape(mod, numSamples, currentModulationType);
+    }
+    else {
+        auto* next = modScratch.data();
+        renderModulationShape(mod, numSamples, currentModulationType);
+        renderModulationShape(next, numSamples, targetModulationType);
+
+        for (int i = 0; i < numSamples; ++i) {
+            const float crossfade = modulationTypeCrossfade.getNextValue();
+            mod[i] += crossfade * (next[i] - mod[i]);
+        }
+
+        // Check if crossfade is complete
+        constexpr float epsilon = 0.001f;
+        if (std::abs(modulationTypeCrossfade.getTargetValue() - 1.0f) < epsilon &&
+            modulationTypeCrossfade.getCurrentValue() >= (1.0f - epsilon)) {
+            currentModulationType = targetModulationType;
+            modulationTypeCrossfade.setCurrentAndTargetValue(0.0f);
+        }
+    }
+
+    // 2. Delay times in samples (stereo spreading)
+    renderDelayTimes(numSamples);
+
+    // 3. Fractional reads
+    auto* wetL = wetBufferL.data();
+    auto* wetR = wetBufferR.data();
+    readLagrange(ringL.data(), ringMask, writePos, delayBufferL.data(), wetL, numSamples);
+    readLagrange(ringR.data(), ringMask, writePos, delayBufferR.data(), wetR, numSamples);
+
+    // 4. Feedback matrix, then tap reads adding their sends
+    renderFeedback(numSamples);
+
+    const bool hasTaps = numTaps > 0;
+    if (hasTaps)
+        processTaps(numSamples);
+
+    // 5. Loop filter and write input plus feedback
+    if (loopFilterEnabled) {
+        applyLoopFilter(feedbackBufferL.data(), numSamples, 0);
+        applyLoopFilter(feedbackBufferR.data(), numSamples, 1);
+    }
+
+    writeToRing(ringL, left, feedbackBufferL.data(), numSamples);
+    writeToRing(ringR, right, feedbackBufferR.data(), numSamples);
+    writePos = (writePos + numSamples) & ringMask;
+
+    if (hasTaps) {
+        juce::FloatVectorOperations::add(wetL, tapWetL.data(), numSamples);
+        juce::FloatVectorOperations::add(wetR, tapWetR.data(), numSamples);
+    }
+
+    // 6. Mix dry and wet signals
+    if (!params.mix.isSmoothing()) {
+        const float wetMix = params.mix.getTargetValue();
+        juce::FloatVectorOperations::multiply(left, 1.0f - wetMix, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(left, wetL, wetMix, numSamples);
+        juce::FloatVectorOperations::multiply(right, 1.0f - wetMix, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(right, wetR, wetMix, numSamples);
+    }
+    else {
+        for (int i = 0; i < numSamples; ++i) {
+            const float wetMix = params.mix.getNextValue();
+            left[i] = left[i] * (1.0f - wetMix) + wetL[i] * wetMix;
+            right[i] = right[i] * (1.0f - wetMix) + wetR[i] * wetMix;
+        }
+    }
+}
+
+void ModDelay::renderPhase(int numSamples) {
+    // Normalised phase in [0, 1) for each sample of the chunk
+    auto* dest = phaseBuffer.data();
+    const float invSampleRate = 1.0f / sampleRate;
+
+    if (!params.modRateHz.isSmoothing()) {
+        const float increment = params.modRateHz.getNextValue() * invSampleRate;
+
+        for (int i = 0; i < numSamples; ++i) {
+            const float p = phase + static_cast<float>(i) * increment;
+            dest[i] = p - std::floor(p);
+        }
+
+        phase += static_cast<float>(numSamples) * increment;
+    }
+    else {
+        for (int i = 0; i < numSamples; ++i) {
+            dest[i] = phase - std::floor(phase);
+            phase += params.modRateHz.getNextValue() * invSampleRate;
+        }
+    }
+
+    phase -= std::floor(phase);
+}
+
+void ModDelay::renderModulationShape(float* dest, int numSamples, ModulationType type) {
+    // Unit-depth waveform from the phase buffer; one branch-free loop per type
+    const auto* p = phaseBuffer.data();
+
+    switch (type) {
+    case ModulationType::Sine:
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = std::sin(juce::MathConstants<float>::twoPi * p[i]);
+        break;
+    case ModulationType::Triangle:
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = 2.0f * std::abs(2.0f * (p[i] - 0.5f)) - 1.0f;
+        break;
+    case ModulationType::Square:
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = p[i] < 0.5f ? 1.0f : -1.0f;
+        break;
+    case ModulationType::SawtoothUp:
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = 2.0f * p[i] - 1.0f;
+        break;
+    case ModulationType::SawtoothDown:
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = 1.0f - 2.0f * p[i];
+        break;
+    default:
+        juce::FloatVectorOperations::clear(dest, numSamples);
+        break;
+    }
+}
+
+void ModDelay::renderDelayTimes(int numSamples) {
+    // delayL = (delay + mod) ms, delayR = (delay - mod) ms, with the depth
+    // kept far enough below the delay that reads never cross the minimum
+    const float msToSamples = 0.001f * sampleRate;
+    const auto* mod = modBuffer.data();
+    auto* dL = delayBufferL.data();
+    auto* dR = delayBufferR.data();
+
+    if (!params.delayMs.isSmoothing() && !params.modDepth.isSmoothing()) {
+        const float dMs = std::max(params.delayMs.getNextValue(), minDelayMs);
+        const float depth = params.modDepth.getNextValue();
+        const float safeDepth = juce::jlimit(0.0f, depth, (dMs - minDelayMs) * 0.8f);
+        const float base = dMs * msToSamples;
+
+        juce::FloatVectorOperations::multiply(dL, mod, safeDepth * msToSamples, numSamples);
+        juce::FloatVectorOperations::negate(dR, dL, numSamples);
+        juce::FloatVectorOperations::add(dL, base, numSamples);
+        juce::FloatVectorOperations::add(dR, base, numSamples);
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float dMs = std::max(params.delayMs.getNextValue(), minDelayMs);
+        const float depth = params.modDepth.getNextValue();
+        const float safeDepth = juce::jlimit(0.0f, depth, (dMs - minDelayMs) * 0.8f);
+        const float offset = mod[i] * safeDepth;
+
+        dL[i] = (dMs + offset) * msToSamples;
+        dR[i] = (dMs - offset) * msToSamples;
+    }
+}
+
+void ModDelay::renderFeedback(int numSamples) {
+    // [fbL; fbR] = M [wetL; wetR]
+    const auto* wetL = wetBufferL.data();
+    const auto* wetR = wetBufferR.data();
+    auto* fbL = feedbackBufferL.data();
+    auto* fbR = feedbackBufferR.data();
+    auto& p = params;
+
+    if (!p.feedbackLFromL.isSmoothing() && !p.feedbackLFromR.isSmoothing()
+        && !p.feedbackRFromL.isSmoothing() && !p.feedbackRFromR.isSmoothing()) {
+        juce::FloatVectorOperations::multiply(fbL, wetL, p.feedbackLFromL.getNextValue(), numSamples);
+        juce::FloatVectorOperations::addWithMultiply(fbL, wetR, p.feedbackLFromR.getNextValue(), numSamples);
+        juce::FloatVectorOperations::multiply(fbR, wetL, p.feedbackRFromL.getNextValue(), numSamples);
+        juce::FloatVectorOperations::addWithMultiply(fbR, wetR, p.feedbackRFromR.getNextValue(), numSamples);
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+        fbL[i] = p.feedbackLFromL.getNextValue() * wetL[i] + p.feedbackLFromR.getNextValue() * wetR[i];
+        fbR[i] = p.feedbackRFromL.getNextValue() * wetL[i] + p.feedbackRFromR.getNextValue() * wetR[i];
+    }
+}
+
+void ModDelay::applyLoopFilter(float* data, int numSamples, size_t channel) {
+    // A bypassed high cut has pole 0 (passes x); a bypassed low cut has
+    // pole 1, so its lowpass stays at zero and subtracts nothing
+    const float hp = highCutPole;
+    const float lp = lowCutPole;
+    float highCut = highCutState[channel];
+    float lowCut = lowCutState[channel];
 
     for (int i = 0; i < numSamples; ++i) {
-        // Get next smoothed values
-        float dMs = std::max(params.delayMs.getNextValue(), 5.0f);
-        float depth = params.modDepth.getNextValue();
-        float rateHz = params.modRateHz.getNextValue();
-        float fbL = juce::jlimit(0.0f, 0.95f, params.feedbackL.getNextValue());
-        float fbR = juce::jlimit(0.0f, 0.95f, params.feedbackR.getNextValue());
-        float wetMix = params.mix.getNextValue();
-        crossfade = modulationTypeCrossfade.getNextValue();
+        highCut = data[i] + hp * (highCut - data[i]);
+        lowCut = highCut + lp * (lowCut - highCut);
+        data[i] = highCut - lowCut;
+    }
+
+    highCutState[channel] = highCut;
+    lowCutState[channel] = lowCut;
+}
 
-        // Calculate safe modulation depth - ensure we stay away from boundaries
-        float safeDepth = std::min(depth, (dMs - 5.0f) * 0.8f);
-        safeDepth = std::max(safeDepth, 0.0f);
+void ModDelay::processTaps(int numSamples) {
+    // Accumulates every active tap into the tap wet buffers and adds its
+    // sends to the feedback buffers. The main delay's reads are done, so
+    // its delay buffers are reused.
+    const float msToSamples = 0.001f * sampleRate;
+    const auto* mod = modBuffer.data();
+    auto* dL = delayBufferL.data();
+    auto* dR = delayBufferR.data();
+    auto* readL = tapReadL.data();
+    auto* readR = tapReadR.data();
+    auto* outL = tapWetL.data();
+    auto* outR = tapWetR.data();
+    auto* fbL = feedbackBufferL.data();
+    auto* fbR = feedbackBufferR.data();
 
-        // Calculate modulation for both waveform types (for crossfading)
-        float mod1 = calculateModulation(phase, safeDepth, currentModulationType);
-        float mod2 = calculateModulation(phase, safeDepth, targetModulationType);
-        float mod = juce::jmap(crossfade, 0.0f, 1.0f, mod1, mod2);
+    juce::FloatVectorOperations::clear(outL, numSamples);
+    juce::FloatVectorOperations::clear(outR, numSamples);
 
-        // Calculate delay times with modulation (stereo spreading)
-        float delayLInSamples = (dMs + mod) * 0.001f * sampleRate;
-        float delayRInSamples = (dMs - mod) * 0.001f * sampleRate;
+    for (int t = 0; t < numTaps; ++t) {
+        auto& tap = taps[static_cast<size_t>(t)];
 
-        // Get input samples
-        float inL = left[i];
-        float inR = right[i];
+        if (!tap.timeMs.isSmoothing() && !tap.modDepthMs.isSmoothing()) {
+            const float timeMs = std::max(tap.timeMs.getNextValue(), minDelayMs);
+            const float safeDepth = juce::jlimit(0.0f, tap.modDepthMs.getNextValue(), (timeMs - minDelayMs) * 0.8f);
+            const float base = timeMs * msToSamples;
 
-        // Read from delay lines
-        float outL = delayL.popSample(0, delayLInSamples, true);
-        float outR = delayR.popSample(1, delayRInSamples, true);
+            juce::FloatVectorOperations::multiply(dL, mod, safeDepth * msToSamples, numSamples);
+            juce::FloatVectorOperations::negate(dR, dL, numSamples);
+            juce::FloatVectorOperations::add(dL, base, numSamples);
+            juce::FloatVectorOperations::add(dR, base, numSamples);
+        }
+        else {
+            for (int i = 0; i < numSamples; ++i) {
+                const float timeMs = std::max(tap.timeMs.getNextValue(), minDelayMs);
+                const float safeDepth = juce::jlimit(0.0f, tap.modDepthMs.getNextValue(), (timeMs - minDelayMs) * 0.8f);
+                const float offset = mod[i] * safeDepth;
 
-        // Write to delay lines with feedback
-        delayL.pushSample(0, inL + outL * fbL);
-        delayR.pushSample(1, inR + outR * fbR);
+                dL[i] = (timeMs + offset) * msToSamples;
+                dR[i] = (timeMs - offset) * msToSamples;
+            }
+        }
 
-        // Mix dry and wet signals
-        left[i] = inL * (1.0f - wetMix) + outL * wetMix;
-        right[i] = inR * (1.0f - wetMix) + outR * wetMix;
+        readLagrange(ringL.data(), ringMask, writePos, dL, readL, numSamples);
+        readLagrange(ringR.data(), ringMask, writePos, dR, readR, numSamples);
 
-        // Advance phase
-        phase += rateHz * invSampleRate;
-        phase = std::fmod(phase, 1.0f);
+        if (!tap.gainL.isSmoothing() && !tap.gainR.isSmoothing() && !tap.send.isSmoothing()) {
+            const float send = tap.send.getNextValue();
+            juce::FloatVectorOperations::addWithMultiply(outL, readL, tap.gainL.getNextValue(), numSamples);
+            juce::FloatVectorOperations::addWithMultiply(outR, readR, tap.gainR.getNextValue(), numSamples);
+            juce::FloatVectorOperations::addWithMultiply(fbL, readL, send, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(fbR, readR, send, numSamples);
+        }
+        else {
+            for (int i = 0; i < numSamples; ++i) {
+                const float send = tap.send.getNextValue();
+                outL[i] += readL[i] * tap.gainL.getNextValue();
+                outR[i] += readR[i] * tap.gainR.getNextValue();
+                fbL[i] += readL[i] * send;
+                fbR[i] += readR[i] * send;
+            }
+        }
     }
+}
+
+void ModDelay::readLagrange(const float* ring, int mask, int startPos,
+    const float* delays, float* dest, int numSamples) {
+    // Third-order Lagrange through the points at delays floor(d) - 1 to
+    // floor(d) + 2, matching DelayLineInterpolationTypes::Lagrange3rd.
+    // Delays are always well above one sample, so truncation is floor.
+    for (int i = 0; i < numSamples; ++i) {
+        const float d = delays[i];
+        const int delayInt = static_cast<int>(d) - 1;
+        const float frac = d - static_cast<float>(delayInt);
 
-    // Check if crossfade is complete
-    constexpr float epsilon = 0.001f;
-    if (std::abs(modulationTypeCrossfade.getTargetValue() - 1.0f) < epsilon &&
-        crossfade >= (1.0f - epsilon)) {
-        currentModulationType = targetModulationType;
-        modulationTypeCrossfade.setCurrentAndTargetValue(0.0f);
+        const int newest = startPos + i - delayInt;
+        const float v1 = ring[newest & mask];
+        const float v2 = ring[(newest - 1) & mask];
+        const float v3 = ring[(newest - 2) & mask];
+        const float v4 = ring[(newest - 3) & mask];
+
+        const float d1 = frac - 1.0f;
+        const float d2 = frac - 2.0f;
+        const float d3 = frac - 3.0f;
+
+        const float c1 = -d1 * d2 * d3 * (1.0f / 6.0f);
+        const float c2 = d2 * d3 * 0.5f;
+        const float c3 = -d1 * d3 * 0.5f;
+        const float c4 = d1 * d2 * (1.0f / 6.0f);
+
+        dest[i] = v1 * c1 + frac * (v2 * c2 + v3 * c3 + v4 * c4);
     }
 }
 
+void ModDelay::writeToRing(std::vector<float>& ring, const float* input, const float* feedback, int numSamples) {
+    // At most two contiguous runs either side of the wrap
+    auto* data = ring.data();
+    const int firstRun = juce::jmin(numSamples, ringMask + 1 - writePos);
+
+    juce::FloatVectorOperations::add(data + writePos, input, feedback, firstRun);
+    juce::FloatVectorOperations::add(data, input + firstRun, feedback + firstRun, numSamples - firstRun);
+}
+
 void ModDelay::setModulationType(ModulationType newType) {
     if (!isValidModulationType(newType))
         return;
@@ -120,24 +536,20 @@ void ModDelay::setSyncEnabled(bool shouldSync) {
 void ModDelay::setTempo(float newBpm) {
     bpm = juce::jlimit(20.0f, 999.0f, newBpm);
     updateEffectiveRate();
+    updateEffectiveDelay();
 }
 
-float ModDelay::calculateModulation(float currentPhase, float depth, ModulationType type) {
-    float phaseWrapped = currentPhase - std::floor(currentPhase);
+void ModDelay::setDelayDivision(NoteDivision newDivision) {
+    delayDivision = newDivision;
+    updateEffectiveDelay();
+}
 
-    switch (type) {
-    case ModulationType::Sine:
-        return std::sin(juce::MathConstants<float>::twoPi * phaseWrapped) * depth;
-    case ModulationType::Triangle:
-        return (2.0f * std::abs(2.0f * (phaseWrapped - 0.5f)) - 1.0f) * depth;
-    case ModulationType::Square:
-        return (phaseWrapped < 0.5f ? 1.0f : -1.0f) * depth;
-    case ModulationType::SawtoothUp:
-        return (2.0f * phaseWrapped - 1.0f) * depth;
-    case ModulationType::SawtoothDown:
-        return (1.0f - 2.0f * phaseWrapped) * depth;
-    default:
-        return 0.0f;
+void ModDelay::setPpqPosition(double ppqPosition) {
+    // In sync the LFO runs 1 / rawRate cycles per beat, so its phase is a
+    // pure function of the host position
+    if (syncEnabled && rawRate > 0.0f) {
+        const double cycles = ppqPosition / static_cast<double>(rawRate);
+        phase = static_cast<float>(cycles - std::floor(cycles));
     }
 }
 
@@ -153,6 +565,31 @@ void ModDelay::updateEffectiveRate() {
     params.modRateHz.setTargetValue(getEffectiveRateHz());
 }
 
+void ModDelay::updateEffectiveDelay() {
+    const float beats = noteDivisionToBeats(delayDivision);
+    const float delayMs = beats > 0.0f ? beats * 60000.0f / bpm : rawDelayMs;
+    params.delayMs.setTargetValue(juce::jmin(delayMs, maxDelayMs));
+}
+
+float ModDelay::noteDivisionToBeats(NoteDivision division) {
+    switch (division) {
+    case NoteDivision::ThirtySecond:     return 0.125f;
+    case NoteDivision::SixteenthTriplet: return 1.0f / 6.0f;
+    case NoteDivision::Sixteenth:        return 0.25f;
+    case NoteDivision::SixteenthDotted:  return 0.375f;
+    case NoteDivision::EighthTriplet:    return 1.0f / 3.0f;
+    case NoteDivision::Eighth:           return 0.5f;
+    case NoteDivision::EighthDotted:     return 0.75f;
+    case NoteDivision::QuarterTriplet:   return 2.0f / 3.0f;
+    case NoteDivision::Quarter:          return 1.0f;
+    case NoteDivision::QuarterDotted:    return 1.5f;
+    case NoteDivision::Half:             return 2.0f;
+    case NoteDivision::Whole:            return 4.0f;
+    case NoteDivision::Free:
+    default:                             return 0.0f;
+    }
+}
+
 bool ModDelay::isValidModulationType(ModulationType type) const {
     int typeValue = static_cast<int>(type);
     return typeValue >= static_cast<int>(ModulationType::Sine) &&
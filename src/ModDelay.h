@@ -1,6 +1,8 @@
 #pragma once
 #include <juce_core/juce_core.h>
 #include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
 
 class ModDelay {
 public:
@@ -12,6 +14,45 @@ public:
         SawtoothDown
     };
 
+    // Tempo-synced delay lengths; Free uses the delay time in ms
+    enum class NoteDivision {
+        Free,
+        ThirtySecond,
+        SixteenthTriplet,
+        Sixteenth,
+        SixteenthDotted,
+        EighthTriplet,
+        Eighth,
+        EighthDotted,
+        QuarterTriplet,
+        Quarter,
+        QuarterDotted,
+        Half,
+        Whole
+    };
+
+    static constexpr int maxTaps = 16;
+
+    // How the delayed signal is routed back into the rings. feedbackL/R
+    // from setParams() are the two loop gains; in MidSide they act on mid
+    // and side instead of left and right.
+    enum class FeedbackMode {
+        Independent,  // L -> L, R -> R
+        PingPong,     // L -> R, R -> L
+        Cross,        // Each pass rotates the stereo image by 45 degrees
+        MidSide
+    };
+
+    // Extra read heads on the same rings as the main delay. Times are
+    // clamped to 5-2000 ms and every field is smoothed.
+    struct TapSettings {
+        float timeMs = 250.0f;
+        float gain = 0.0f;        // 0 to 1
+        float pan = 0.0f;         // -1 (left) to 1 (right), equal power
+        float feedback = 0.0f;    // 0 to 0.95, sent back into the rings; see maxLoopGain
+        float modDepthMs = 0.0f;  // Shared LFO, spread L/R like the main delay
+    };
+
     ModDelay() = default;
     ~ModDelay() = default;
 
@@ -23,26 +64,90 @@ public:
     ModulationType getModulationType() const { return currentModulationType; }
     void setSyncEnabled(bool shouldSync);
     void setTempo(float newBpm);
+    void setDelayDivision(NoteDivision newDivision);
+    void setPpqPosition(double ppqPosition); // Locks the synced LFO phase to the host
+    float getDelayTimeMs() const { return params.delayMs.getTargetValue(); }
+    void setFeedbackMode(FeedbackMode newMode);
+    void setFeedbackFilter(float lowCutHz, float highCutHz); // One-pole cuts inside the loop
+
+    void setTap(int index, const TapSettings& settings);
+    void setNumTaps(int newNumTaps); // 0 to maxTaps
+    int getNumTaps() const { return numTaps; }
 
 private:
     struct ModDelayParameters {
         juce::LinearSmoothedValue<float> delayMs;
         juce::LinearSmoothedValue<float> modDepth;
         juce::LinearSmoothedValue<float> modRateHz;
-        juce::LinearSmoothedValue<float> feedbackL;
-        juce::LinearSmoothedValue<float> feedbackR;
+        juce::LinearSmoothedValue<float> feedbackLFromL;
+        juce::LinearSmoothedValue<float> feedbackLFromR;
+        juce::LinearSmoothedValue<float> feedbackRFromL;
+        juce::LinearSmoothedValue<float> feedbackRFromR;
         juce::LinearSmoothedValue<float> mix;
 
         void reset(double sampleRate, double smoothingTime) {
-            for (auto* p : { &delayMs, &modDepth, &modRateHz, &feedbackL, &feedbackR, &mix }) {
+            for (auto* p : { &delayMs, &modDepth, &modRateHz, &feedbackLFromL, &feedbackLFromR,
+                            &feedbackRFromL, &feedbackRFromR, &mix }) {
                 p->reset(sampleRate, smoothingTime);
                 p->setCurrentAndTargetValue(0.0f);
             }
         }
     };
 
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> delayL;
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> delayR;
+    static constexpr float minDelayMs = 5.0f;
+    static constexpr float maxDelayMs = 2000.0f;
+    static constexpr float maxDepthMs = 100.0f;
+
+    // Ceiling on the feedback matrix gain plus every tap's send. All of
+    // them feed the same rings, so each held below 0.95 on its own could
+    // still add up to a loop gain above one.
+    static constexpr float maxLoopGain = 0.95f;
+
+    // Power-of-two delay rings, indexed forwards in time. Blocks are split
+    // into chunks no longer than the minimum delay, so every read in a chunk
+    // hits samples written by earlier chunks and the reads, the feedback
+    // write and the mix can each run as a separate pass.
+    std::vector<float> ringL, ringR;
+    int ringMask = 0;
+    int writePos = 0;
+
+    struct Tap {
+        juce::LinearSmoothedValue<float> timeMs;
+        juce::LinearSmoothedValue<float> modDepthMs;
+        juce::LinearSmoothedValue<float> gainL;
+        juce::LinearSmoothedValue<float> gainR;
+        juce::LinearSmoothedValue<float> send;
+        float requestedSend = 0.0f;   // gain * feedback, before the loop gain limit
+    };
+
+    std::array<Tap, maxTaps> taps;
+    int numTaps = 0;
+
+    // Feedback matrix inputs
+    FeedbackMode feedbackMode = FeedbackMode::Independent;
+    float feedbackGainL = 0.0f;
+    float feedbackGainR = 0.0f;
+    bool loopGainsChanged = false;   // Matrix and sends are recomputed once per block
+
+    // One-pole loop filters: high cut is a lowpass, low cut subtracts a
+    // second lowpass. Coefficients are pole radii exp(-2 pi fc / fs).
+    float lowCutHz = 20.0f;
+    float highCutHz = 20000.0f;
+    float lowCutPole = 0.0f;
+    float highCutPole = 0.0f;
+    bool loopFilterEnabled = false;
+    std::array<float, 2> highCutState{};
+    std::array<float, 2> lowCutState{};
+
+    // Chunk scratch buffers, sized in prepare()
+    std::vector<float> phaseBuffer;
+    std::vector<float> modBuffer, modScratch;
+    std::vector<float> delayBufferL, delayBufferR;
+    std::vector<float> wetBufferL, wetBufferR;
+    std::vector<float> tapReadL, tapReadR;
+    std::vector<float> tapWetL, tapWetR;
+    std::vector<float> feedbackBufferL, feedbackBufferR;
+    int maxChunkSize = 0;
 
     float sampleRate = 44100.0f;
     float phase = 0.0f;
@@ -53,12 +158,28 @@ private:
     float bpm = 120.0f;
     bool syncEnabled = false;
     float rawRate = 1.0f;
+    float rawDelayMs = 0.0f;
+    NoteDivision delayDivision = NoteDivision::Free;
 
     ModDelayParameters params;
 
-    float calculateModulation(float phaseNorm, float depth, ModulationType type);
+    // Block pipeline stages
+    void processChunk(float* left, float* right, int numSamples);
+    void renderPhase(int numSamples);
+    void renderModulationShape(float* dest, int numSamples, ModulationType type);
+    void renderDelayTimes(int numSamples);
+    void processTaps(int numSamples);
+    void renderFeedback(int numSamples);
+    void applyLoopFilter(float* data, int numSamples, size_t channel);
+    void updateFeedbackMatrix();
+    void updateLoopFilter();
+    static void readLagrange(const float* ring, int mask, int startPos,
+        const float* delays, float* dest, int numSamples);
+    void writeToRing(std::vector<float>& ring, const float* input, const float* feedback, int numSamples);
     float getEffectiveRateHz() const;
     void updateEffectiveRate();
+    void updateEffectiveDelay();
+    static float noteDivisionToBeats(NoteDivision division);
     bool isValidModulationType(ModulationType type) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModDelay)
@@ -0,0 +1,508 @@
+#include "PartitionedConvolver.h"
+
+namespace
+{
+    int divideRoundingUp(int numerator, int denominator)
+    {
+        return (numerator + denominator - 1) / denominator;
+    }
+}
+
+//==============================================================================
+class PartitionedConvolver::TailThread : public juce::Thread
+{
+public:
+    explicit TailThread(PartitionedConvolver& convolverToRun)
+        : juce::Thread("Convolution tail"), owner(convolverToRun)
+    {
+    }
+
+    void run() override
+    {
+        // The audio thread wakes us whenever it completes a stage block
+        while (! threadShouldExit())
+            if (! owner.runTailStep())
+                wait(100);
+    }
+
+private:
+    PartitionedConvolver& owner;
+};
+
+//==============================================================================
+void PartitionedConvolver::Segment::prepare(const juce::AudioBuffer<float>& impulse, int offset, int size, int partitions, int channels)
+{
+    blockSize = size;
+    numBins = size + 1;
+    numPartitions = partitions;
+    newestSlot = 0;
+
+    const int fftSize = size * 2;
+    fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(static_cast<double>(fftSize))));
+
+    const auto spectrumSize = static_cast<size_t>(channels * partitions * numBins);
+    filterReal.assign(spectrumSize, 0.0f);
+    filterImag.assign(spectrumSize, 0.0f);
+    inputReal.assign(spectrumSize, 0.0f);
+    inputImag.assign(spectrumSize, 0.0f);
+    sumReal.assign(static_cast<size_t>(channels * numBins), 0.0f);
+    sumImag.assign(static_cast<size_t>(channels * numBins), 0.0f);
+    fftBuffer.assign(static_cast<size_t>(fftSize * 2), 0.0f);
+
+    // Each partition is a block of the impulse, zero-padded to the FFT size
+    const int impulseChannels = impulse.getNumChannels();
+    const int impulseLength = impulse.getNumSamples();
+
+    for (int channel = 0; channel < channels; ++channel)
+    {
+        const float* source = impulse.getReadPointer(juce::jmin(channel, impulseChannels - 1));
+
+        for (int partition = 0; partition < partitions; ++partition)
+        {
+            const int start = offset + partition * size;
+            const int count = juce::jlimit(0, size, impulseLength - start);
+
+            std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+            std::copy(source + start, source + start + count, fftBuffer.begin());
+            fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+            const auto base = static_cast<size_t>((channel * partitions + partition) * numBins);
+            for (size_t bin = 0; bin < static_cast<size_t>(numBins); ++bin)
+            {
+                filterReal[base + bin] = fftBuffer[bin * 2];
+                filterImag[base + bin] = fftBuffer[bin * 2 + 1];
+            }
+        }
+    }
+}
+
+void PartitionedConvolver::Segment::clear()
+{
+    std::fill(inputReal.begin(), inputReal.end(), 0.0f);
+    std::fill(inputImag.begin(), inputImag.end(), 0.0f);
+    std::fill(sumReal.begin(), sumReal.end(), 0.0f);
+    std::fill(sumImag.begin(), sumImag.end(), 0.0f);
+    newestSlot = 0;
+}
+
+void PartitionedConvolver::Segment::advance()
+{
+    if (numPartitions > 0)
+        newestSlot = (newestSlot + 1) % numPartitions;
+}
+
+void PartitionedConvolver::Segment::pushInput(int channel, const float* frame)
+{
+    // The frame is the previous block followed by the newest one (overlap-save)
+    std::copy(frame, frame + blockSize * 2, fftBuffer.begin());
+    fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+    const auto base = static_cast<size_t>((channel * numPartitions + newestSlot) * numBins);
+    for (size_t bin = 0; bin < static_cast<size_t>(numBins); ++bin)
+    {
+        inputReal[base + bin] = fftBuffer[bin * 2];
+        inputImag[base + bin] = fftBuffer[bin * 2 + 1];
+    }
+}
+
+void PartitionedConvolver::Segment::accumulate(int channel, int partition)
+{
+    // Partition p of the impulse meets the input from p blocks ago
+    const int slot = (newestSlot + numPartitions - partition) % numPartitions;
+    const auto inputBase = static_cast<size_t>((channel * numPartitions + slot) * numBins);
+    const auto filterBase = static_cast<size_t>((channel * numPartitions + partition) * numBins);
+
+    const float* xr = inputReal.data() + inputBase;
+    const float* xi = inputImag.data() + inputBase;
+    const float* hr = filterReal.data() + filterBase;
+    const float* hi = filterImag.data() + filterBase;
+    float* sr = sumReal.data() + static_cast<size_t>(channel * numBins);
+    float* si = sumImag.data() + static_cast<size_t>(channel * numBins);
+
+    if (partition == 0)
+    {
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            sr[bin] = xr[bin] * hr[bin] - xi[bin] * hi[bin];
+            si[bin] = xr[bin] * hi[bin] + xi[bin] * hr[bin];
+        }
+    }
+    else
+    {
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            sr[bin] += xr[bin] * hr[bin] - xi[bin] * hi[bin];
+            si[bin] += xr[bin] * hi[bin] + xi[bin] * hr[bin];
+        }
+    }
+}
+
+void PartitionedConvolver::Segment::computeOutput(int channel, float* output)
+{
+    const float* sr = sumReal.data() + static_cast<size_t>(channel * numBins);
+    const float* si = sumImag.data() + static_cast<size_t>(channel * numBins);
+
+    for (size_t bin = 0; bin < static_cast<size_t>(numBins); ++bin)
+    {
+        fftBuffer[bin * 2] = sr[bin];
+        fftBuffer[bin * 2 + 1] = si[bin];
+    }
+
+    fft->performRealOnlyInverseTransform(fftBuffer.data());
+
+    // The first half wrapped around; the second half is the new block
+    std::copy(fftBuffer.begin() + blockSize, fftBuffer.begin() + blockSize * 2, output);
+}
+
+//==============================================================================
+PartitionedConvolver::Stage::Stage()
+{
+    for (auto& block : resultBlock)
+        block.store(-1, std::memory_order_relaxed);
+
+    for (auto& resultEpochTag : resultEpoch)
+        resultEpochTag.store(-1, std::memory_order_relaxed);
+}
+
+//==============================================================================
+PartitionedConvolver::PartitionedConvolver(const juce::AudioBuffer<float>& impulse, int channels, int blockSize)
+    : numChannels(channels), impulseLength(impulse.getNumSamples()), maxBlockSize(blockSize)
+{
+    const int impulseChannels = impulse.getNumChannels();
+
+    // The first head block runs as a direct FIR, so there is no latency
+    firLength = juce::jmin(headSize, impulseLength);
+    firTaps.assign(static_cast<size_t>(numChannels * headSize), 0.0f);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* source = impulse.getReadPointer(juce::jmin(channel, impulseChannels - 1));
+        std::copy(source, source + firLength, firTaps.begin() + channel * headSize);
+    }
+
+    // The partitioned head runs up to where the first stage starts
+    const int headEnd = juce::jmin(impulseLength, firstStageSize * 2);
+    head.prepare(impulse, headSize, headSize, divideRoundingUp(juce::jmax(0, headEnd - headSize), headSize), numChannels);
+
+    headFrame.setSize(numChannels, headSize * 2);
+    headOutput.setSize(numChannels, headSize);
+    headFrame.clear();
+    headOutput.clear();
+
+    // A stage starts two of its blocks in and runs until the next, larger
+    // stage starts; the largest takes whatever is left
+    for (int size = firstStageSize; size <= maxStageSize && size * 2 < impulseLength; size *= stageGrowth)
+    {
+        const int start = size * 2;
+        const int end = size < maxStageSize ? juce::jmin(impulseLength, start * stageGrowth) : impulseLength;
+
+        auto stage = std::make_unique<Stage>();
+        stage->segment.prepare(impulse, start, size, divideRoundingUp(end - start, size), numChannels);
+        stage->frame.setSize(numChannels, size * 2);
+
+        for (auto& result : stage->results)
+        {
+            result.setSize(numChannels, size);
+            result.clear();
+        }
+
+        stages.push_back(std::move(stage));
+    }
+
+    if (! stages.empty())
+    {
+        // A block has to stay readable until its result is due, allowing
+        // for a host block that is being written at the time
+        const int historySize = juce::nextPowerOfTwo(stages.back()->segment.blockSize * 3 + maxBlockSize);
+        history.setSize(numChannels, historySize);
+        history.clear();
+        historyMask = historySize - 1;
+
+        tailThread = std::make_unique<TailThread>(*this);
+        tailThread->startThread(juce::Thread::Priority::high);
+    }
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    if (tailThread != nullptr)
+        tailThread->stopThread(1000);
+}
+
+void PartitionedConvolver::reset()
+{
+    // headFill is kept so head and stage blocks stay aligned with the clock
+    head.clear();
+    headFrame.clear();
+    headOutput.clear();
+
+    for (auto& stage : stages)
+        stage->playing = -1;
+
+    // The tail thread clears its own state when it sees the new epoch, and
+    // treats everything before this point as silence
+    resetClock.store(clock, std::memory_order_relaxed);
+    epoch.store(++audioEpoch, std::memory_order_release);
+}
+
+void PartitionedConvolver::process(juce::dsp::AudioBlock<float>& block)
+{
+    const int channels = juce::jmin(numChannels, static_cast<int>(block.getNumChannels()));
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    bool submittedWork = false;
+
+    for (int position = 0; position < numSamples;)
+    {
+        // Never cross a head block boundary, which is where stage blocks end too
+        const int count = juce::jmin(numSamples - position, headSize - headFill);
+        const int historyPos = static_cast<int>(clock & historyMask);
+        const int firstSpan = juce::jmin(count, historyMask + 1 - historyPos);
+
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            float* samples = block.getChannelPointer(static_cast<size_t>(channel)) + position;
+            float* frame = headFrame.getWritePointer(channel, headSize + headFill);
+
+            juce::FloatVectorOperations::copy(frame, samples, count);
+
+            if (! stages.empty())
+            {
+                float* input = history.getWritePointer(channel);
+                juce::FloatVectorOperations::copy(input + historyPos, samples, firstSpan);
+                juce::FloatVectorOperations::copy(input, samples + firstSpan, count - firstSpan);
+            }
+
+            // The input is safe in the frame, so the output can replace it
+            juce::FloatVectorOperations::copy(samples, headOutput.getReadPointer(channel, headFill), count);
+
+            const float* taps = firTaps.data() + channel * headSize;
+            for (int tap = 0; tap < firLength; ++tap)
+                juce::FloatVectorOperations::addWithMultiply(samples, frame - tap, taps[tap], count);
+
+            for (auto& stage : stages)
+            {
+                if (stage->playing < 0)
+                    continue;
+
+                const int offset = static_cast<int>(clock & (stage->segment.blockSize - 1));
+                juce::FloatVectorOperations::add(samples, stage->results[static_cast<size_t>(stage->playing)].getReadPointer(channel, offset), count);
+            }
+        }
+
+        clock += count;
+        headFill += count;
+        position += count;
+
+        if (headFill == headSize)
+        {
+            processHeadBlock();
+            headFill = 0;
+
+            for (auto& stage : stages)
+            {
+                if ((clock & (stage->segment.blockSize - 1)) == 0)
+                    submittedWork = finishStageBlock(*stage) || submittedWork;
+            }
+        }
+    }
+
+    publishedClock.store(clock, std::memory_order_release);
+
+    if (submittedWork)
+        tailThread->notify();
+}
+
+void PartitionedConvolver::processHeadBlock()
+{
+    if (head.numPartitions > 0)
+    {
+        head.advance();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            head.pushInput(channel, headFrame.getReadPointer(channel));
+
+            for (int partition = 0; partition < head.numPartitions; ++partition)
+                head.accumulate(channel, partition);
+
+            head.computeOutput(channel, headOutput.getWritePointer(channel));
+        }
+    }
+
+    // Slide the frame along by a block
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* frame = headFrame.getWritePointer(channel);
+        std::copy(frame + headSize, frame + headSize * 2, frame);
+    }
+}
+
+bool PartitionedConvolver::finishStageBlock(Stage& stage)
+{
+    const int size = stage.segment.blockSize;
+    const juce::int64 completedBlocks = clock / size;
+
+    // The result due now is the one for the block before last
+    const juce::int64 due = completedBlocks - 2;
+    stage.playing = -1;
+
+    if (due >= 0)
+    {
+        const int slot = static_cast<int>(due & 1);
+
+        if (stage.resultBlock[static_cast<size_t>(slot)].load(std::memory_order_acquire) == due
+            && stage.resultEpoch[static_cast<size_t>(slot)].load(std::memory_order_relaxed) == audioEpoch)
+        {
+            stage.playing = slot;
+        }
+        else if ((due + 1) * size > resetClock.load(std::memory_order_relaxed))
+        {
+            if (nonRealtime && waitForResult(stage, due))
+                stage.playing = slot;
+            else
+                missedDeadlines.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    stage.lastSubmitted.store(completedBlocks - 1, std::memory_order_release);
+    return true;
+}
+
+bool PartitionedConvolver::waitForResult(Stage& stage, juce::int64 block)
+{
+    // The tail thread only gives up on a job once the published clock has
+    // passed its deadline, and process() doesn't publish the clock until it
+    // returns, so the tail thread always gets to this block
+    while (stage.tailProgress.load(std::memory_order_acquire) <= block)
+    {
+        tailThread->notify();
+        tailProgressed.wait(1);
+    }
+
+    const auto slot = static_cast<size_t>(block & 1);
+    return stage.resultBlock[slot].load(std::memory_order_acquire) == block
+        && stage.resultEpoch[slot].load(std::memory_order_relaxed) == audioEpoch;
+}
+
+//==============================================================================
+bool PartitionedConvolver::runTailStep()
+{
+    const int currentEpoch = epoch.load(std::memory_order_acquire);
+    if (currentEpoch != tailEpoch)
+    {
+        // The audio thread has been reset: drop everything from before
+        tailEpoch = currentEpoch;
+        tailResetClock = resetClock.load(std::memory_order_relaxed);
+
+        for (auto& stage : stages)
+        {
+            stage->segment.clear();
+            stage->nextStep = 0;
+        }
+    }
+
+    // Earliest deadline first; a job in progress can be overtaken between steps
+    Stage* next = nullptr;
+    juce::int64 nextDeadline = 0;
+
+    for (auto& stage : stages)
+    {
+        if (stage->nextStep == 0 && stage->lastSubmitted.load(std::memory_order_acquire) < stage->nextBlock)
+            continue;
+
+        const juce::int64 deadline = (stage->nextBlock + 2) * stage->segment.blockSize;
+        if (next == nullptr || deadline < nextDeadline)
+        {
+            next = stage.get();
+            nextDeadline = deadline;
+        }
+    }
+
+    if (next == nullptr)
+        return false;
+
+    runStageStep(*next);
+    return true;
+}
+
+void PartitionedConvolver::runStageStep(Stage& stage)
+{
+    auto& segment = stage.segment;
+    const juce::int64 deadline = (stage.nextBlock + 2) * segment.blockSize;
+
+    if (stage.nextStep == 0)
+    {
+        stage.jobEpoch = tailEpoch;
+        gatherStageInput(stage);
+        segment.advance();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            segment.pushInput(channel, stage.frame.getReadPointer(channel));
+    }
+    else if (stage.nextStep <= segment.numPartitions)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            segment.accumulate(channel, stage.nextStep - 1);
+    }
+    else
+    {
+        const auto slot = static_cast<size_t>(stage.nextBlock & 1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            segment.computeOutput(channel, stage.results[slot].getWritePointer(channel));
+
+        stage.resultEpoch[slot].store(stage.jobEpoch, std::memory_order_relaxed);
+        stage.resultBlock[slot].store(stage.nextBlock, std::memory_order_release);
+        finishStageJob(stage);
+        return;
+    }
+
+    // Once the input spectrum is in the delay line, a result that can no
+    // longer make its deadline isn't worth finishing
+    if (publishedClock.load(std::memory_order_relaxed) >= deadline)
+    {
+        finishStageJob(stage);
+        return;
+    }
+
+    ++stage.nextStep;
+}
+
+void PartitionedConvolver::finishStageJob(Stage& stage)
+{
+    ++stage.nextBlock;
+    stage.nextStep = 0;
+
+    stage.tailProgress.store(stage.nextBlock, std::memory_order_release);
+    tailProgressed.signal();
+}
+
+void PartitionedConvolver::gatherStageInput(Stage& stage)
+{
+    const int size = stage.segment.blockSize;
+    const int frameLength = size * 2;
+    const int historySize = historyMask + 1;
+    const juce::int64 frameStart = (stage.nextBlock - 1) * size;
+
+    const int position = static_cast<int>(frameStart & historyMask);
+    const int firstSpan = juce::jmin(frameLength, historySize - position);
+
+    // Anything from before the last reset, or before the start, is silence
+    const auto silentLength = static_cast<int>(juce::jlimit<juce::int64>(0, frameLength, juce::jmax<juce::int64>(tailResetClock, 0) - frameStart));
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* input = history.getReadPointer(channel);
+        float* frame = stage.frame.getWritePointer(channel);
+
+        std::copy(input + position, input + position + firstSpan, frame);
+        std::copy(input, input + frameLength - firstSpan, frame + firstSpan);
+        std::fill(frame, frame + silentLength, 0.0f);
+    }
+
+    // If the audio thread may have started overwriting the frame during the
+    // copy, the job is hopelessly late anyway: use silence, not a torn block
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (publishedClock.load(std::memory_order_relaxed) + maxBlockSize > frameStart + historySize)
+        stage.frame.clear();
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Zero-latency convolution with a non-uniformly partitioned impulse
+ *
+ * The audio thread runs the first 64 samples of the impulse as a direct FIR
+ * and the rest of the first 1024 as a uniformly partitioned FFT convolution
+ * in 64-sample blocks. Everything after that is split into stages whose
+ * partitions grow by four each time, from 512 up to 32768 samples.
+ *
+ * A stage starts two of its own blocks into the impulse, so each result is
+ * due a whole block period after its input is complete. A background thread
+ * computes the stages earliest deadline first, one partition at a time, so a
+ * long job never holds up a more urgent one. The audio thread only ever
+ * picks up finished results; one that misses its deadline is dropped instead
+ * of stalling the callback. When rendering offline there are no deadlines:
+ * the calling thread waits for each result instead, so a bounce always
+ * contains the whole impulse.
+ *
+ * The impulse is fixed for the lifetime of the object; build a new one off
+ * the audio thread to change it.
+ */
+class PartitionedConvolver
+{
+public:
+    /** Partitions the impulse for the given channel count; channels beyond the impulse's reuse its last one */
+    PartitionedConvolver(const juce::AudioBuffer<float>& impulse, int numChannels, int maxBlockSize);
+    ~PartitionedConvolver();
+
+    //==============================================================================
+    /** Clears the convolution history; safe to call from the audio thread */
+    void reset();
+
+    /** Replaces the block with the convolved signal */
+    void process(juce::dsp::AudioBlock<float>& block);
+
+    /** When set, process() waits for late tail blocks rather than dropping them */
+    void setNonRealtime(bool shouldBeNonRealtime) noexcept { nonRealtime = shouldBeNonRealtime; }
+
+    //==============================================================================
+    /** Returns the impulse length in samples */
+    int getImpulseLength() const noexcept { return impulseLength; }
+
+    /** Returns how many tail blocks were not ready in time since construction */
+    int getMissedDeadlines() const noexcept { return missedDeadlines.load(std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    static constexpr int headSize = 64;
+    static constexpr int firstStageSize = 512;
+    static constexpr int maxStageSize = 32768;
+    static constexpr int stageGrowth = 4;
+
+    // One uniformly partitioned convolution: the impulse partitions and a
+    // frequency-domain delay line of input spectra, both in split complex
+    // form so the multiply-accumulate vectorises
+    struct Segment
+    {
+        void prepare(const juce::AudioBuffer<float>& impulse, int offset, int size, int partitions, int channels);
+        void clear();
+        void advance();
+        void pushInput(int channel, const float* frame);
+        void accumulate(int channel, int partition);
+        void computeOutput(int channel, float* output);
+
+        int blockSize = 0;
+        int numBins = 0;
+        int numPartitions = 0;
+        int newestSlot = 0;
+
+        std::unique_ptr<juce::dsp::FFT> fft;
+        std::vector<float> filterReal, filterImag;  // [channel][partition][bin]
+        std::vector<float> inputReal, inputImag;    // [channel][slot][bin]
+        std::vector<float> sumReal, sumImag;        // [channel][bin]
+        std::vector<float> fftBuffer;
+    };
+
+    // A tail stage. The audio thread publishes each completed input block
+    // through lastSubmitted; the tail thread writes the result into one of
+    // two buffers and tags it with the block and reset epoch it belongs to
+    struct Stage
+    {
+        Stage();
+
+        Segment segment;
+        std::array<juce::AudioBuffer<float>, 2> results;
+        std::array<std::atomic<juce::int64>, 2> resultBlock;
+        std::array<std::atomic<int>, 2> resultEpoch;
+        std::atomic<juce::int64> lastSubmitted { -1 };
+        std::atomic<juce::int64> tailProgress { 0 };   // nextBlock, as the tail thread last left it
+
+        int playing = -1;                   // Audio thread: result being played, or -1
+
+        juce::int64 nextBlock = 0;          // Tail thread: job in progress or next due
+        int nextStep = 0;                   // 0 = not started, then one per partition
+        int jobEpoch = 0;
+        juce::AudioBuffer<float> frame;     // Two blocks of input for the FFT
+    };
+
+    class TailThread;
+
+    //==============================================================================
+    int numChannels = 0;
+    int impulseLength = 0;
+    int maxBlockSize = 0;
+
+    // Audio thread state
+    Segment head;
+    int firLength = 0;
+    std::vector<float> firTaps;             // [channel][tap]
+    juce::AudioBuffer<float> headFrame;     // Last two head blocks of input
+    juce::AudioBuffer<float> headOutput;    // Partitioned head output for the current block
+    int headFill = 0;
+    juce::int64 clock = 0;                  // Samples processed since construction
+    int audioEpoch = 0;
+    bool nonRealtime = false;
+
+    // Input history the tail thread reads its blocks from
+    juce::AudioBuffer<float> history;
+    int historyMask = 0;
+
+    std::vector<std::unique_ptr<Stage>> stages;
+
+    // Shared between the threads
+    std::atomic<juce::int64> publishedClock { 0 };
+    std::atomic<juce::int64> resetClock { 0 };
+    std::atomic<int> epoch { 0 };
+    std::atomic<int> missedDeadlines { 0 };
+    juce::WaitableEvent tailProgressed;
+
+    // Tail thread state
+    int tailEpoch = 0;
+    juce::int64 tailResetClock = 0;
+    std::unique_ptr<TailThread> tailThread;
+
+    //==============================================================================
+    void processHeadBlock();
+    bool finishStageBlock(Stage& stage);
+    bool waitForResult(Stage& stage, juce::int64 block);
+
+    bool runTailStep();
+    void runStageStep(Stage& stage);
+    void finishStageJob(Stage& stage);
+    void gatherStageInput(Stage& stage);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PartitionedConvolver)
+};
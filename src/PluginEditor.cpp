@@ -11,6 +11,20 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(AudioPluginAudi
     microPitchDetuneComponent = std::make_unique<MicroPitchDetuneComponent>(p.parameters);
     exciterSaturationComponent = std::make_unique<ExciterSaturationComponent>(p.parameters);
     simpleVerbComponent = std::make_unique<SimpleVerbWithPredelayComponent>(p.parameters);
+    simpleVerbComponent->onImpulseResponseChosen = [this](const juce::File& file)
+        {
+            if (processorRef.loadImpulseResponse(file))
+                simpleVerbComponent->setImpulseResponseName(file.getFileNameWithoutExtension());
+        };
+
+    if (p.getImpulseResponseFile().existsAsFile())
+        simpleVerbComponent->setImpulseResponseName(p.getImpulseResponseFile().getFileNameWithoutExtension());
+
+    simpleVerbComponent->onReducedRateChanged = [this](bool shouldReduceRate)
+        {
+            processorRef.setReverbReducedRate(shouldReduceRate);
+        };
+    simpleVerbComponent->setReducedRate(p.getReverbReducedRate());
 
     presetManager = std::make_unique<PerceptionPresetManager>(
         *tiltEQComponent, *widthBalancerComponent, *modDelayComponent,
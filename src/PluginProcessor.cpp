@@ -12,8 +12,9 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
 #endif
     )
     , parameters(*this, nullptr, "PARAMETERS", createParameterLayout())
-    , bpm(120.0)
 {
+    cacheParameterPointers();
+
     // Set initial modulation type for ModDelay
     modDelay.setModulationType(ModDelay::ModulationType::Sine);
 }
@@ -60,7 +61,12 @@ bool AudioPluginAudioProcessor::isMidiEffect() const
 
 double AudioPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The reverb tail (up to a 10s impulse) after the longest pre-delay
+    const double sampleRate = getSampleRate();
+    if (sampleRate <= 0.0)
+        return 0.0;
+
+    return (simpleVerbWithPredelay.getTailLengthSamples() + simpleVerbWithPredelay.getMaxPredelaySamples()) / sampleRate;
 }
 
 int AudioPluginAudioProcessor::getNumPrograms()
@@ -102,19 +108,7 @@ void AudioPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerB
     spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
 
     // Get BPM from host if available
-    if (auto* playHead = getPlayHead())
-    {
-        juce::AudioPlayHead::CurrentPositionInfo info;
-        if (playHead->getCurrentPosition(info))
-        {
-            bpm = info.bpm > 0.0 ? info.bpm : 120.0;
-
-
-
-
-
-        }
-    }
+    updateTransport();
 
     // Prepare all effect processors
     widthBalancer.prepare(spec);
@@ -122,11 +116,177 @@ void AudioPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerB
     modDelay.prepare(spec);
     spatialFX.prepare(spec);
     microPitchDetune.prepare(spec);
+    updateExciterHarmonics();
+    updateExciterOversampling();    // Applied immediately by prepare()
     exciterSaturation.prepare(spec);
+    simpleVerbWithPredelay.setReducedRate(getReverbReducedRate());
     simpleVerbWithPredelay.prepare(spec);
 
-    // Allocate dry buffer for potential future wet/dry mixing
-    dryBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    updateRandomSeeds();
+
+    microPitchDetune.setEngine(static_cast<MicroPitchDetune::Engine>(
+        static_cast<int>(raw.pitchEngine->load())));
+    updateReportedLatency();
+}
+
+void AudioPluginAudioProcessor::updateRandomSeeds()
+{
+    // Deterministic renders derive every seed from the parameter state, so the
+    // same session renders identically and can be null-tested; otherwise each
+    // prepare draws fresh seeds
+    const bool deterministic = parameters.getRawParameterValue("deterministicRender")->load();
+    const auto baseSeed = deterministic
+        ? static_cast<juce::uint64>(parameters.copyState().toXmlString().hashCode64())
+        : static_cast<juce::uint64>(juce::Random::getSystemRandom().nextInt64());
+
+    spatialFX.setSeed(baseSeed);
+    microPitchDetune.setSeed(baseSeed + 1);
+}
+
+void AudioPluginAudioProcessor::updateReportedLatency()
+{
+    // Only effects that delay their whole output (dry included) contribute
+    const int latency = microPitchDetune.getLatencySamples()
+        + exciterSaturation.getLatencySamples();
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+void AudioPluginAudioProcessor::updateExciterHarmonics()
+{
+    // Ahead of the oversampling, since Auto follows the highest harmonic in use
+    exciterSaturation.setHarmonicMode(static_cast<ExciterSaturation::HarmonicMode>(
+        static_cast<int>(raw.exciterHarmonicMode->load())));
+
+    for (int order = 2; order <= ExciterSaturation::maxChebyshevOrder; ++order)
+        exciterSaturation.setChebyshevGain(order, raw.exciterHarmonic[static_cast<size_t>(order - 2)]->load());
+}
+
+void AudioPluginAudioProcessor::updateExciterOversampling()
+{
+    // Auto: what the current harmonics need in realtime, the most when
+    // rendering offline
+    const int choice = static_cast<int>(raw.exciterOversampling->load());
+    const int factor = choice >= 4
+        ? (isNonRealtime() ? 8 : exciterSaturation.getRecommendedOversamplingFactor())
+        : 1 << choice;
+
+    exciterSaturation.setOversamplingFactor(factor);
+    exciterSaturation.setOversamplingFilter(static_cast<ExciterSaturation::OversamplingFilter>(
+        static_cast<int>(raw.exciterOversamplingFilter->load())));
+}
+
+void AudioPluginAudioProcessor::cacheParameterPointers()
+{
+    auto lookup = [this](const juce::String& parameterID)
+    {
+        auto* value = parameters.getRawParameterValue(parameterID);
+        jassert(value != nullptr);
+        return value;
+    };
+
+    raw.sync = lookup("sync");
+    raw.tiltEQ = lookup("tiltEQ");
+    raw.width = lookup("width");
+    raw.midSideBalance = lookup("midSideBalance");
+    raw.mono = lookup("mono");
+    raw.intensity = lookup("intensity");
+    raw.delayTime = lookup("delayTime");
+    raw.delayDivision = lookup("delayDivision");
+    raw.modDepth = lookup("modDepth");
+    raw.modRate = lookup("modRate");
+    raw.feedbackL = lookup("feedbackL");
+    raw.feedbackR = lookup("feedbackR");
+    raw.modMix = lookup("modMix");
+    raw.modulationType = lookup("modulationType");
+    raw.feedbackMode = lookup("feedbackMode");
+    raw.feedbackLowCut = lookup("feedbackLowCut");
+    raw.feedbackHighCut = lookup("feedbackHighCut");
+    raw.tapCount = lookup("tapCount");
+    raw.tapSpacing = lookup("tapSpacing");
+    raw.tapDecay = lookup("tapDecay");
+    raw.tapSpread = lookup("tapSpread");
+    raw.tapFeedback = lookup("tapFeedback");
+    raw.phaseOffsetL = lookup("phaseOffsetL");
+    raw.phaseOffsetR = lookup("phaseOffsetR");
+    raw.sfxModRateL = lookup("sfxModRateL");
+    raw.sfxModRateR = lookup("sfxModRateR");
+    raw.sfxModDepthL = lookup("sfxModDepthL");
+    raw.sfxModDepthR = lookup("sfxModDepthR");
+    raw.sfxWetDryMix = lookup("sfxWetDryMix");
+    raw.sfxLfoPhaseOffset = lookup("sfxLfoPhaseOffset");
+    raw.sfxAllpassFreq = lookup("sfxAllpassFreq");
+    raw.sfxAllpassStages = lookup("sfxAllpassStages");
+    raw.sfxAllpassSpread = lookup("sfxAllpassSpread");
+    raw.sfxRandomRate = lookup("sfxRandomRate");
+    raw.haasDelayL = lookup("haasDelayL");
+    raw.haasDelayR = lookup("haasDelayR");
+    raw.modulationShape = lookup("modulationShape");
+    raw.sfxPhaseMode = lookup("sfxPhaseMode");
+    raw.sfxDecorrelation = lookup("sfxDecorrelation");
+    raw.sfxVelvetDensity = lookup("sfxVelvetDensity");
+    raw.detuneAmount = lookup("detuneAmount");
+    raw.lfoRate = lookup("lfoRate");
+    raw.lfoDepth = lookup("lfoDepth");
+    raw.delayCentre = lookup("delayCentre");
+    raw.stereoSeparation = lookup("stereoSeparation");
+    raw.mix = lookup("mix");
+    raw.pitchVoices = lookup("pitchVoices");
+    raw.pitchEngine = lookup("pitchEngine");
+    raw.exciterDrive = lookup("exciterDrive");
+    raw.exciterMix = lookup("exciterMix");
+    raw.exciterHighpass = lookup("exciterHighpass");
+    raw.exciterHarmonicMode = lookup("exciterHarmonicMode");
+
+    for (int order = 2; order <= ExciterSaturation::maxChebyshevOrder; ++order)
+        raw.exciterHarmonic[static_cast<size_t>(order - 2)] = lookup(("exciterHarmonic" + juce::String(order)));
+
+    raw.exciterAntialiasing = lookup("exciterAntialiasing");
+    raw.exciterOversampling = lookup("exciterOversampling");
+    raw.exciterOversamplingFilter = lookup("exciterOversamplingFilter");
+    raw.exciterBands = lookup("exciterBands");
+
+    for (int k = 0; k < ExciterSaturation::maxBands - 1; ++k)
+        raw.exciterCrossover[static_cast<size_t>(k)] = lookup(("exciterCrossover" + juce::String(k + 1)));
+
+    for (int band = 0; band < ExciterSaturation::maxBands; ++band)
+    {
+        const auto prefix = "exciterBand" + juce::String(band + 1);
+        raw.exciterBandDrive[static_cast<size_t>(band)] = lookup((prefix + "Drive"));
+        raw.exciterBandMix[static_cast<size_t>(band)] = lookup((prefix + "Mix"));
+        raw.exciterBandType[static_cast<size_t>(band)] = lookup((prefix + "Type"));
+    }
+    raw.predelayMs = lookup("predelayMs");
+    raw.size = lookup("size");
+    raw.damping = lookup("damping");
+    raw.wet = lookup("wet");
+    raw.reverbEngine = lookup("reverbEngine");
+    raw.reverbModulation = lookup("reverbModulation");
+}
+
+void AudioPluginAudioProcessor::updateTransport()
+{
+    // Keeps the last known tempo if the host stops reporting one
+    transport.isPlaying = false;
+    transport.hasPpqPosition = false;
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (const auto position = playHead->getPosition())
+        {
+            if (const auto hostBpm = position->getBpm(); hostBpm && *hostBpm > 0.0)
+                transport.bpm = *hostBpm;
+
+            if (const auto ppq = position->getPpqPosition())
+            {
+                transport.ppqPosition = *ppq;
+                transport.hasPpqPosition = true;
+            }
+
+            transport.isPlaying = position->getIsPlaying();
+        }
+    }
 }
 
 void AudioPluginAudioProcessor::releaseResources()
@@ -171,11 +331,13 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     // Wrap the buffer for DSP processing
     juce::dsp::AudioBlock<float> block(buffer);
 
-    // Optional: Copy input to dry buffer for wet/dry mixing
-    // dryBuffer.makeCopyOf(buffer, true);
+    // Read the transport once; every tempo-aware effect sees the same snapshot
+    updateTransport();
+    const auto bpm = static_cast<float>(transport.bpm);
+    const bool lockToHost = transport.isPlaying && transport.hasPpqPosition;
 
     // Get sync state
-    bool syncEnabled = parameters.getRawParameterValue("sync")->load();
+    bool syncEnabled = raw.sync->load();
 
     //==============================================================================
     // Effect chain processing order (psychoacoustic signal flow)
@@ -183,17 +345,17 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 
     // 1. TiltEQ - Spectral balance adjustment
     {
-        float tilt = *parameters.getRawParameterValue("tiltEQ");
+        float tilt = *raw.tiltEQ;
         tiltEQ.setTilt(tilt);
         tiltEQ.process(block);
     }
 
     // 2. WidthBalancer - Stereo field manipulation
     {
-        float width = *parameters.getRawParameterValue("width");
-        float balance = *parameters.getRawParameterValue("midSideBalance");
-        bool mono = parameters.getRawParameterValue("mono")->load();
-        float intensity = *parameters.getRawParameterValue("intensity");
+        float width = *raw.width;
+        float balance = *raw.midSideBalance;
+        bool mono = raw.mono->load() > 0.5f;
+        float intensity = *raw.intensity;
 
         widthBalancer.setWidth(width);
         widthBalancer.setMidSideBalance(balance);
@@ -204,84 +366,169 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
 
     // 3. ModDelay - Modulated delay effects
     {
-        float delayTime = *parameters.getRawParameterValue("delayTime");
-        float depth = *parameters.getRawParameterValue("modDepth");
-        float rate = *parameters.getRawParameterValue("modRate");
-        float feedbackL = *parameters.getRawParameterValue("feedbackL");
-        float feedbackR = *parameters.getRawParameterValue("feedbackR");
-        float modMix = *parameters.getRawParameterValue("modMix");
-        int modulationTypeValue = parameters.state.getProperty("modulationType");
-
-        ModDelay::ModulationType modulationType = static_cast<ModDelay::ModulationType>(modulationTypeValue);
+        float delayTime = *raw.delayTime;
+        float depth = *raw.modDepth;
+        float rate = *raw.modRate;
+        float feedbackL = *raw.feedbackL;
+        float feedbackR = *raw.feedbackR;
+        float modMix = *raw.modMix;
+
+        // Choice indices are zero-based, ModulationType starts at Sine = 1
+        auto modulationType = static_cast<ModDelay::ModulationType>(
+            static_cast<int>(raw.modulationType->load()) + 1);
+        auto delayDivision = static_cast<ModDelay::NoteDivision>(
+            static_cast<int>(raw.delayDivision->load()));
         modDelay.setModulationType(modulationType);
-        modDelay.setTempo(static_cast<float>(bpm));
+        modDelay.setTempo(bpm);
         modDelay.setSyncEnabled(syncEnabled);
+        modDelay.setDelayDivision(delayDivision);
+        auto feedbackMode = static_cast<ModDelay::FeedbackMode>(
+            static_cast<int>(raw.feedbackMode->load()));
+        float feedbackLowCut = *raw.feedbackLowCut;
+        float feedbackHighCut = *raw.feedbackHighCut;
+        modDelay.setFeedbackMode(feedbackMode);
+        modDelay.setFeedbackFilter(feedbackLowCut, feedbackHighCut);
         modDelay.setParams(delayTime, depth, rate, feedbackL, feedbackR, modMix);
+
+        if (lockToHost)
+            modDelay.setPpqPosition(transport.ppqPosition);
+
+        // Rhythmic taps after the main delay, alternating sides; they follow
+        // the synced delay time when a note division is selected
+        int tapCount = static_cast<int>(raw.tapCount->load());
+        float tapSpacing = *raw.tapSpacing;
+        float tapDecay = *raw.tapDecay;
+        float tapSpread = *raw.tapSpread;
+        float tapFeedback = *raw.tapFeedback;
+        float tapBaseMs = modDelay.getDelayTimeMs();
+
+        ModDelay::TapSettings tap;
+        tap.gain = 1.0f;
+        tap.feedback = tapFeedback;
+        tap.modDepthMs = depth;
+        for (int t = 0; t < tapCount; ++t)
+        {
+            tap.timeMs = tapBaseMs + tapSpacing * static_cast<float>(t + 1);
+            tap.gain *= tapDecay;
+            tap.pan = (t % 2 == 0) ? -tapSpread : tapSpread;
+            modDelay.setTap(t, tap);
+        }
+        modDelay.setNumTaps(tapCount);
         modDelay.process(block);
     }
 
     // 4. SpatialFX - Spatial positioning and phase manipulation
     {
-        float phaseOffsetL = *parameters.getRawParameterValue("phaseOffsetL");
-        float phaseOffsetR = *parameters.getRawParameterValue("phaseOffsetR");
-        float sfxModRateL = *parameters.getRawParameterValue("sfxModRateL");
-        float sfxModRateR = *parameters.getRawParameterValue("sfxModRateR");
-        float sfxModDepthL = *parameters.getRawParameterValue("sfxModDepthL");
-        float sfxModDepthR = *parameters.getRawParameterValue("sfxModDepthR");
-        float mixValue = *parameters.getRawParameterValue("sfxWetDryMix");
-        float sfxLfoPhaseOffset = *parameters.getRawParameterValue("sfxLfoPhaseOffset");
-        float allpassFreq = *parameters.getRawParameterValue("sfxAllpassFreq");
-        float haasDelayL = *parameters.getRawParameterValue("haasDelayL");
-        float haasDelayR = *parameters.getRawParameterValue("haasDelayR");
-        int modulationShapeValue = parameters.state.getProperty("modulationShape");
-
-        SpatialFX::LfoWaveform modulationShape = static_cast<SpatialFX::LfoWaveform>(modulationShapeValue);
+        float phaseOffsetL = *raw.phaseOffsetL;
+        float phaseOffsetR = *raw.phaseOffsetR;
+        float sfxModRateL = *raw.sfxModRateL;
+        float sfxModRateR = *raw.sfxModRateR;
+        float sfxModDepthL = *raw.sfxModDepthL;
+        float sfxModDepthR = *raw.sfxModDepthR;
+        float mixValue = *raw.sfxWetDryMix;
+        float sfxLfoPhaseOffset = *raw.sfxLfoPhaseOffset;
+        float allpassFreq = *raw.sfxAllpassFreq;
+        int allpassStages = static_cast<int>(raw.sfxAllpassStages->load());
+        float allpassSpread = *raw.sfxAllpassSpread;
+        float randomRate = *raw.sfxRandomRate;
+        float haasDelayL = *raw.haasDelayL;
+        float haasDelayR = *raw.haasDelayR;
+
+        // Choice indices are zero-based, LfoWaveform starts at Sine = 1
+        auto modulationShape = static_cast<SpatialFX::LfoWaveform>(
+            static_cast<int>(raw.modulationShape->load()) + 1);
+        auto phaseMode = static_cast<SpatialFX::PhaseMode>(
+            static_cast<int>(raw.sfxPhaseMode->load()));
+        auto decorrelationMode = static_cast<SpatialFX::DecorrelationMode>(
+            static_cast<int>(raw.sfxDecorrelation->load()));
+        auto velvetDensity = static_cast<SpatialFX::VelvetDensity>(
+            static_cast<int>(raw.sfxVelvetDensity->load()));
         spatialFX.setPhaseAmount(phaseOffsetL, phaseOffsetR);
         spatialFX.setLfoRate(sfxModRateL, sfxModRateR);
         spatialFX.setLfoDepth(sfxModDepthL, sfxModDepthR);
         spatialFX.setWetDry(mixValue);
         spatialFX.setLfoPhaseOffset(sfxLfoPhaseOffset);
         spatialFX.setAllpassFrequency(allpassFreq);
+        spatialFX.setAllpassStages(allpassStages);
+        spatialFX.setAllpassSpread(allpassSpread);
         spatialFX.setHaasDelayMs(haasDelayL, haasDelayR);
         spatialFX.setLfoWaveform(modulationShape);
+        spatialFX.setRandomUpdateRate(randomRate);
+        spatialFX.setPhaseMode(phaseMode);
+        spatialFX.setDecorrelationMode(decorrelationMode);
+        spatialFX.setVelvetDensity(velvetDensity);
         spatialFX.process(block);
     }
 
     // 5. MicroPitchDetune - Subtle pitch shifting for thickness
     {
-        float detuneAmount = *parameters.getRawParameterValue("detuneAmount");
-        float lfoRate = *parameters.getRawParameterValue("lfoRate");
-        float lfoDepth = *parameters.getRawParameterValue("lfoDepth");
-        float delayCentre = *parameters.getRawParameterValue("delayCentre");
-        float stereoSeparation = *parameters.getRawParameterValue("stereoSeparation");
-        float mix = *parameters.getRawParameterValue("mix");
+        float detuneAmount = *raw.detuneAmount;
+        float lfoRate = *raw.lfoRate;
+        float lfoDepth = *raw.lfoDepth;
+        float delayCentre = *raw.delayCentre;
+        float stereoSeparation = *raw.stereoSeparation;
+        float mix = *raw.mix;
+        int voices = static_cast<int>(raw.pitchVoices->load());
+        auto engine = static_cast<MicroPitchDetune::Engine>(
+            static_cast<int>(raw.pitchEngine->load()));
 
         microPitchDetune.setParams(detuneAmount, lfoRate, lfoDepth,
             delayCentre, stereoSeparation, mix);
-        microPitchDetune.setBpm(static_cast<float>(bpm));
+        microPitchDetune.setBpm(bpm);
+        microPitchDetune.setSyncEnabled(syncEnabled);
+        microPitchDetune.setNumVoices(voices);
+        microPitchDetune.setEngine(engine);
+
+        if (lockToHost)
+            microPitchDetune.setPpqPosition(transport.ppqPosition);
+
         microPitchDetune.process(block);
     }
 
     // 6. ExciterSaturation - Harmonic enhancement
     {
-        float drive = *parameters.getRawParameterValue("exciterDrive");
-        float exciterMix = *parameters.getRawParameterValue("exciterMix");
-        float highpassFreq = *parameters.getRawParameterValue("exciterHighpass");
+        float drive = *raw.exciterDrive;
+        float exciterMix = *raw.exciterMix;
+        float highpassFreq = *raw.exciterHighpass;
 
         exciterSaturation.setDrive(drive);
         exciterSaturation.setMix(exciterMix);
         exciterSaturation.setHighpass(highpassFreq);
+        exciterSaturation.setAntialiasing(static_cast<ExciterSaturation::Antialiasing>(
+            static_cast<int>(raw.exciterAntialiasing->load())));
+        exciterSaturation.setNumBands(static_cast<int>(raw.exciterBands->load()));
+        for (int k = 0; k < ExciterSaturation::maxBands - 1; ++k)
+            exciterSaturation.setCrossoverFrequency(k, raw.exciterCrossover[static_cast<size_t>(k)]->load());
+
+        for (int band = 0; band < ExciterSaturation::maxBands; ++band)
+        {
+            const auto index = static_cast<size_t>(band);
+            exciterSaturation.setBandDrive(band, raw.exciterBandDrive[index]->load());
+            exciterSaturation.setBandMix(band, raw.exciterBandMix[index]->load());
+            exciterSaturation.setBandSaturationType(band, static_cast<ExciterSaturation::SaturationType>(
+                static_cast<int>(raw.exciterBandType[index]->load())));
+        }
+
+        updateExciterHarmonics();
+        updateExciterOversampling();
         exciterSaturation.process(block);
+
+        // After both latency-carrying stages, so it runs once per block
+        updateReportedLatency();
     }
 
     // 7. SimpleVerbWithPredelay - Reverb with pre-delay
     {
-        float predelayMs = *parameters.getRawParameterValue("predelayMs");
-        float size = *parameters.getRawParameterValue("size");
-        float damping = *parameters.getRawParameterValue("damping");
-        float wet = *parameters.getRawParameterValue("wet");
+        float predelayMs = *raw.predelayMs;
+        float size = *raw.size;
+        float damping = *raw.damping;
+        float wet = *raw.wet;
 
         simpleVerbWithPredelay.setParams(predelayMs, size, damping, wet);
+        simpleVerbWithPredelay.setEngine(static_cast<SimpleVerbWithPredelay::Engine>(
+            static_cast<int>(raw.reverbEngine->load())));
+        simpleVerbWithPredelay.setModulationDepth(*raw.reverbModulation);
+        simpleVerbWithPredelay.setNonRealtime(isNonRealtime());
         simpleVerbWithPredelay.process(block);
     }
 }
@@ -316,15 +563,59 @@ void AudioPluginAudioProcessor::setStateInformation(const void* data, int sizeIn
     {
         parameters.state = tree;
 
-        // Restore modulation type
-        if (tree.hasProperty("modulationType"))
-        {
-            modDelay.setModulationType(
-                static_cast<ModDelay::ModulationType>(static_cast<int>(tree.getProperty("modulationType"))));
-        }
+        // Reload the impulse response; if the file has gone, the IR engine stays silent
+        if (tree.hasProperty("impulseResponse"))
+            simpleVerbWithPredelay.loadImpulseResponse(getImpulseResponseFile());
+
+        applyReverbReducedRate();
     }
 }
 
+bool AudioPluginAudioProcessor::loadImpulseResponse(const juce::File& file)
+{
+    if (! simpleVerbWithPredelay.loadImpulseResponse(file))
+        return false;
+
+    parameters.state.setProperty("impulseResponse", file.getFullPathName(), nullptr);
+    return true;
+}
+
+juce::File AudioPluginAudioProcessor::getImpulseResponseFile() const
+{
+    return juce::File(parameters.state.getProperty("impulseResponse").toString());
+}
+
+void AudioPluginAudioProcessor::setReverbReducedRate(bool shouldReduceRate)
+{
+    parameters.state.setProperty("reverbReducedRate", shouldReduceRate, nullptr);
+    applyReverbReducedRate();
+}
+
+bool AudioPluginAudioProcessor::getReverbReducedRate() const
+{
+    return parameters.state.getProperty("reverbReducedRate", true);
+}
+
+void AudioPluginAudioProcessor::applyReverbReducedRate()
+{
+    const bool shouldReduceRate = getReverbReducedRate();
+    if (shouldReduceRate == simpleVerbWithPredelay.isReducedRate())
+        return;
+
+    // Before the first prepareToPlay the setting is simply picked up there;
+    // after it, the engines are rebuilt with the audio callback held off
+    if (getSampleRate() <= 0.0)
+    {
+        simpleVerbWithPredelay.setReducedRate(shouldReduceRate);
+        return;
+    }
+
+    suspendProcessing(true);
+    simpleVerbWithPredelay.setReducedRate(shouldReduceRate);
+    simpleVerbWithPredelay.prepare(spec);
+    suspendProcessing(false);
+}
+
 //==============================================================================
 // This creates new instances of the plugin
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -404,6 +695,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
         .withStringFromValueFunction(floatToString2dp)
         .withValueFromStringFunction(stringToFloat)));
 
+    // Order matches ModDelay::NoteDivision
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "delayDivision", 1 },
+        "Delay Division",
+        juce::StringArray{ "Free", "1/32", "1/16T", "1/16", "1/16D", "1/8T", "1/8",
+                           "1/8D", "1/4T", "1/4", "1/4D", "1/2", "1/1" },
+        0)); // Default: Free
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{ "feedbackL", 1 },
         "Feedback L",
@@ -450,6 +749,74 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
         .withStringFromValueFunction(floatToString2dp)
         .withValueFromStringFunction(stringToFloat)));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "feedbackMode", 1 },
+        "Feedback Mode",
+        juce::StringArray{ "Independent", "Ping-Pong", "Cross", "Mid/Side" },
+        0)); // Default: Independent
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "feedbackLowCut", 1 },
+        "Feedback Low Cut",
+        juce::NormalisableRange<float>(20.0f, 2000.0f, 1.0f),
+        20.0f,
+        juce::AudioParameterFloatAttributes()
+        .withLabel("Hz")
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "feedbackHighCut", 1 },
+        "Feedback High Cut",
+        juce::NormalisableRange<float>(1000.0f, 20000.0f, 1.0f),
+        20000.0f,
+        juce::AudioParameterFloatAttributes()
+        .withLabel("Hz")
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{ "tapCount", 1 },
+        "Tap Count",
+        0, ModDelay::maxTaps, 0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "tapSpacing", 1 },
+        "Tap Spacing",
+        juce::NormalisableRange<float>(10.0f, 1000.0f, 0.1f),
+        250.0f,
+        juce::AudioParameterFloatAttributes()
+        .withLabel("ms")
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "tapDecay", 1 },
+        "Tap Decay",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.7f,
+        juce::AudioParameterFloatAttributes()
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "tapSpread", 1 },
+        "Tap Spread",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f,
+        juce::AudioParameterFloatAttributes()
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "tapFeedback", 1 },
+        "Tap Feedback",
+        juce::NormalisableRange<float>(0.0f, 0.95f, 0.01f),
+        0.0f,
+        juce::AudioParameterFloatAttributes()
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID{ "modulationType", 1 },
         "Modulation Type",
@@ -461,6 +828,12 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
         "Sync",
         false));
 
+    // Seeds all random generators from the parameter state on prepareToPlay
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{ "deterministicRender", 1 },
+        "Deterministic Render",
+        false));
+
     //==============================================================================
     // SpatialFX Parameters
     //==============================================================================
@@ -545,6 +918,21 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
         .withStringFromValueFunction(floatToString2dp)
         .withValueFromStringFunction(stringToFloat)));
 
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{ "sfxAllpassStages", 1 },
+        "Allpass Stages",
+        1, 8, 1));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "sfxAllpassSpread", 1 },
+        "Allpass Spread",
+        juce::NormalisableRange<float>(0.0f, 2.0f, 0.01f),
+        1.0f,
+        juce::AudioParameterFloatAttributes()
+        .withLabel("oct")
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{ "haasDelayL", 1 },
         "Haas Delay L",
@@ -566,9 +954,37 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID{ "modulationShape", 1 },
         "Modulation Shape",
-        juce::StringArray{ "Sine", "Triangle", "Square", "Random" },
+        juce::StringArray{ "Sine", "Triangle", "Square", "Random", "Smooth Random" },
         0)); // Default: Sine
 
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "sfxRandomRate", 1 },
+        "Random Rate",
+        juce::NormalisableRange<float>(1.0f, 50.0f, 0.1f),
+        10.0f,
+        juce::AudioParameterFloatAttributes()
+        .withLabel("Hz")
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "sfxPhaseMode", 1 },
+        "Phase Mode",
+        juce::StringArray{ "Rotation", "Hilbert" },
+        0)); // Default: Rotation
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "sfxDecorrelation", 1 },
+        "Decorrelation",
+        juce::StringArray{ "Haas + Allpass", "Velvet Noise" },
+        0)); // Default: Haas + Allpass
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "sfxVelvetDensity", 1 },
+        "Velvet Density",
+        juce::StringArray{ "Sparse", "Medium", "Dense" },
+        1)); // Default: Medium
+
     //==============================================================================
     // MicroPitchDetune Parameters
     //==============================================================================
@@ -626,6 +1042,17 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
         .withStringFromValueFunction(floatToString2dp)
         .withValueFromStringFunction(stringToFloat)));
 
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{ "pitchVoices", 1 },
+        "Pitch Voices",
+        1, MicroPitchDetune::MAX_VOICES, 3));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "pitchEngine", 1 },
+        "Pitch Engine",
+        juce::StringArray{ "Modulated", "Granular" },
+        0)); // Default: Modulated
+
     //==============================================================================
     // ExciterSaturation Parameters
     //==============================================================================
@@ -656,6 +1083,93 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
         .withStringFromValueFunction(floatToString2dp)
         .withValueFromStringFunction(stringToFloat)));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "exciterHarmonicMode", 1 },
+        "Exciter Harmonic Mode",
+        juce::StringArray{ "Balanced", "Odd Only", "Even Only", "Chebyshev" },
+        0)); // Default: Balanced
+
+    // Chebyshev mode: the level of each harmonic for a full-scale sine at full drive
+    const std::array<float, ExciterSaturation::maxChebyshevOrder - 1> defaultHarmonics = { 0.2f, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int order = 2; order <= ExciterSaturation::maxChebyshevOrder; ++order)
+    {
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{ "exciterHarmonic" + juce::String(order), 1 },
+            "Exciter Harmonic " + juce::String(order),
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f),
+            defaultHarmonics[static_cast<size_t>(order - 2)],
+            juce::AudioParameterFloatAttributes()
+            .withStringFromValueFunction(floatToString2dp)
+            .withValueFromStringFunction(stringToFloat)));
+    }
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "exciterAntialiasing", 1 },
+        "Exciter Antialiasing",
+        juce::StringArray{ "Off", "ADAA 1st Order", "ADAA 2nd Order" },
+        0)); // Default: Off
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "exciterOversampling", 1 },
+        "Exciter Oversampling",
+        juce::StringArray{ "1x", "2x", "4x", "8x", "Auto" },
+        4)); // Default: Auto (as needed in realtime, 8x offline)
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "exciterOversamplingFilter", 1 },
+        "Exciter Oversampling Filter",
+        juce::StringArray{ "IIR (Minimum Phase)", "FIR (Linear Phase)" },
+        0)); // Default: IIR
+
+    // Multiband mode; one band is the full-band exciter above
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{ "exciterBands", 1 },
+        "Exciter Bands",
+        1, ExciterSaturation::maxBands, 1));
+
+    const std::array<float, ExciterSaturation::maxBands - 1> defaultCrossovers = { 200.0f, 2000.0f, 8000.0f };
+    for (int k = 0; k < ExciterSaturation::maxBands - 1; ++k)
+    {
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{ "exciterCrossover" + juce::String(k + 1), 1 },
+            "Exciter Crossover " + juce::String(k + 1),
+            juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f),
+            defaultCrossovers[static_cast<size_t>(k)],
+            juce::AudioParameterFloatAttributes()
+            .withStringFromValueFunction(floatToString2dp)
+            .withValueFromStringFunction(stringToFloat)));
+    }
+
+    for (int band = 1; band <= ExciterSaturation::maxBands; ++band)
+    {
+        const auto id = "exciterBand" + juce::String(band);
+        const auto name = "Exciter Band " + juce::String(band);
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{ id + "Drive", 1 },
+            name + " Drive",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+            0.5f,
+            juce::AudioParameterFloatAttributes()
+            .withStringFromValueFunction(floatToString2dp)
+            .withValueFromStringFunction(stringToFloat)));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{ id + "Mix", 1 },
+            name + " Mix",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+            1.0f,
+            juce::AudioParameterFloatAttributes()
+            .withStringFromValueFunction(floatToString2dp)
+            .withValueFromStringFunction(stringToFloat)));
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID{ id + "Type", 1 },
+            name + " Type",
+            juce::StringArray{ "Soft", "Hard", "Tube", "Tape", "Transformer", "Digital" },
+            0)); // Default: Soft
+    }
+
     //==============================================================================
     // SimpleVerbWithPredelay Parameters
     //==============================================================================
@@ -696,5 +1210,20 @@ juce::AudioProcessorValueTreeState::ParameterLayout AudioPluginAudioProcessor::c
         .withStringFromValueFunction(floatToString2dp)
         .withValueFromStringFunction(stringToFloat)));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{ "reverbEngine", 1 },
+        "Reverb Engine",
+        juce::StringArray{ "Classic", "FDN", "IR" },
+        1)); // Default: FDN
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{ "reverbModulation", 1 },
+        "Reverb Modulation",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f,
+        juce::AudioParameterFloatAttributes()
+        .withStringFromValueFunction(floatToString2dp)
+        .withValueFromStringFunction(stringToFloat)));
+
     return { params.begin(), params.end() };
 }
\ No newline at end of file
@@ -67,6 +67,17 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    // Loads the impulse response for the IR reverb engine and remembers it in the state
+    bool loadImpulseResponse(const juce::File& file);
+    juce::File getImpulseResponseFile() const;
+
+    // Runs the reverb engines at a reduced rate from 88.2kHz up. A session
+    // setting kept in the state rather than an automatable parameter, since
+    // changing it rebuilds the engines
+    void setReverbReducedRate(bool shouldReduceRate);
+    bool getReverbReducedRate() const;
+
     //==============================================================================
     // Public members
     juce::AudioProcessorValueTreeState parameters;
@@ -83,10 +94,105 @@ public:
 private:
     //==============================================================================
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    void updateRandomSeeds();
+    void cacheParameterPointers();
+    void updateTransport();
+    void updateReportedLatency();
+    void updateExciterHarmonics();
+    void updateExciterOversampling();
+    void applyReverbReducedRate();
+
+    // Host transport, read from the playhead once per block
+    struct TransportSnapshot
+    {
+        double bpm = 120.0;
+        double ppqPosition = 0.0;
+        bool isPlaying = false;
+        bool hasPpqPosition = false;
+    };
+
+    // Parameter values resolved once at construction so processBlock never
+    // looks anything up by string
+    struct RawParameters
+    {
+        std::atomic<float>* sync = nullptr;
+        std::atomic<float>* tiltEQ = nullptr;
+
+        std::atomic<float>* width = nullptr;
+        std::atomic<float>* midSideBalance = nullptr;
+        std::atomic<float>* mono = nullptr;
+        std::atomic<float>* intensity = nullptr;
+
+        std::atomic<float>* delayTime = nullptr;
+        std::atomic<float>* delayDivision = nullptr;
+        std::atomic<float>* modDepth = nullptr;
+        std::atomic<float>* modRate = nullptr;
+        std::atomic<float>* feedbackL = nullptr;
+        std::atomic<float>* feedbackR = nullptr;
+        std::atomic<float>* modMix = nullptr;
+        std::atomic<float>* modulationType = nullptr;
+        std::atomic<float>* feedbackMode = nullptr;
+        std::atomic<float>* feedbackLowCut = nullptr;
+        std::atomic<float>* feedbackHighCut = nullptr;
+        std::atomic<float>* tapCount = nullptr;
+        std::atomic<float>* tapSpacing = nullptr;
+        std::atomic<float>* tapDecay = nullptr;
+        std::atomic<float>* tapSpread = nullptr;
+        std::atomic<float>* tapFeedback = nullptr;
+
+        std::atomic<float>* phaseOffsetL = nullptr;
+        std::atomic<float>* phaseOffsetR = nullptr;
+        std::atomic<float>* sfxModRateL = nullptr;
+        std::atomic<float>* sfxModRateR = nullptr;
+        std::atomic<float>* sfxModDepthL = nullptr;
+        std::atomic<float>* sfxModDepthR = nullptr;
+        std::atomic<float>* sfxWetDryMix = nullptr;
+        std::atomic<float>* sfxLfoPhaseOffset = nullptr;
+        std::atomic<float>* sfxAllpassFreq = nullptr;
+        std::atomic<float>* sfxAllpassStages = nullptr;
+        std::atomic<float>* sfxAllpassSpread = nullptr;
+        std::atomic<float>* sfxRandomRate = nullptr;
+        std::atomic<float>* haasDelayL = nullptr;
+        std::atomic<float>* haasDelayR = nullptr;
+        std::atomic<float>* modulationShape = nullptr;
+        std::atomic<float>* sfxPhaseMode = nullptr;
+        std::atomic<float>* sfxDecorrelation = nullptr;
+        std::atomic<float>* sfxVelvetDensity = nullptr;
+
+        std::atomic<float>* detuneAmount = nullptr;
+        std::atomic<float>* lfoRate = nullptr;
+        std::atomic<float>* lfoDepth = nullptr;
+        std::atomic<float>* delayCentre = nullptr;
+        std::atomic<float>* stereoSeparation = nullptr;
+        std::atomic<float>* mix = nullptr;
+        std::atomic<float>* pitchVoices = nullptr;
+        std::atomic<float>* pitchEngine = nullptr;
+
+        std::atomic<float>* exciterDrive = nullptr;
+        std::atomic<float>* exciterMix = nullptr;
+        std::atomic<float>* exciterHighpass = nullptr;
+        std::atomic<float>* exciterHarmonicMode = nullptr;
+        std::array<std::atomic<float>*, ExciterSaturation::maxChebyshevOrder - 1> exciterHarmonic {};   // Orders 2 and up
+        std::atomic<float>* exciterAntialiasing = nullptr;
+        std::atomic<float>* exciterOversampling = nullptr;
+        std::atomic<float>* exciterOversamplingFilter = nullptr;
+        std::atomic<float>* exciterBands = nullptr;
+        std::array<std::atomic<float>*, ExciterSaturation::maxBands - 1> exciterCrossover {};
+        std::array<std::atomic<float>*, ExciterSaturation::maxBands> exciterBandDrive {};
+        std::array<std::atomic<float>*, ExciterSaturation::maxBands> exciterBandMix {};
+        std::array<std::atomic<float>*, ExciterSaturation::maxBands> exciterBandType {};
+
+        std::atomic<float>* predelayMs = nullptr;
+        std::atomic<float>* size = nullptr;
+        std::atomic<float>* damping = nullptr;
+        std::atomic<float>* wet = nullptr;
+        std::atomic<float>* reverbEngine = nullptr;
+        std::atomic<float>* reverbModulation = nullptr;
+    };
 
     // Processing state
-    juce::AudioBuffer<float> dryBuffer;
-    double bpm = 120.0;
+    TransportSnapshot transport;
+    RawParameters raw;
     juce::dsp::ProcessSpec spec;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
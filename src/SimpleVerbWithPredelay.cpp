@@ -15,13 +15,13 @@ void SimpleVerbWithPredelay::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = spec.sampleRate;
 
-    // Allocate pre-delay buffer (max 500ms)
+    // Allocate pre-delay buffer (max 500ms), plus room for a whole block and
+    // the interpolation taps, rounded up to a power of two for masking
     maxPredelaySamples = static_cast<int>(sampleRate * 0.5);
-    predelayBuffer.setSize(static_cast<int>(spec.numChannels), maxPredelaySamples + 4); // +4 for interpolation
-
-    // Allocate working buffer for reverb processing
-    workingBuffer.setSize(static_cast<int>(spec.numChannels),
-        static_cast<int>(spec.maximumBlockSize));
+    maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+    const int predelaySize = juce::nextPowerOfTwo(maxPredelaySamples + maxBlockSize + 4);
+    predelayBuffer.setSize(static_cast<int>(spec.numChannels), predelaySize);
+    predelayMask = predelaySize - 1;
 
     // Setup parameter smoothing
     const float smoothingTimeSec = smoothingTimeMs * 0.001f;
@@ -31,9 +31,24 @@ void SimpleVerbWithPredelay::prepare(const juce::dsp::ProcessSpec& spec)
     predelaySmoothed.setCurrentAndTargetValue(0.0f);
     wetLevelSmoothed.setCurrentAndTargetValue(targetWetLevel.load(std::memory_order_relaxed));
 
+    // At 88.2kHz and up the engines can run at half or a quarter of the
+    // session rate, so their cost per second stays about the same
+    int rateFactor = 1;
+    while (reducedRate && rateFactor < 4 && sampleRate / (rateFactor * 2) >= 44100.0)
+        rateFactor *= 2;
+
+    rateConverter.prepare(sampleRate, static_cast<int>(spec.numChannels), maxBlockSize, rateFactor);
+
+    const juce::dsp::ProcessSpec engineSpec { sampleRate / rateFactor,
+                                              static_cast<juce::uint32>(rateConverter.getMaxReducedBlockSize()),
+                                              spec.numChannels };
+
     // Prepare reverb
     reverb.setParameters(reverbParams);
-    reverb.prepare(spec);
+    reverb.prepare(engineSpec);
+    fdnReverb.setParameters(reverbParams);
+    fdnReverb.prepare(engineSpec);
+    convolutionReverb.prepare(engineSpec);
 
     reset();
 }
@@ -41,10 +56,13 @@ void SimpleVerbWithPredelay::prepare(const juce::dsp::ProcessSpec& spec)
 void SimpleVerbWithPredelay::reset()
 {
     predelayBuffer.clear();
-    workingBuffer.clear();
+    rateConverter.reset();
     reverb.reset();
+    fdnReverb.reset();
+    convolutionReverb.reset();
 
     predelayWritePos = 0;
+    wasRendering = true;
 
     const float currentPredelay = targetPredelayMs.load(std::memory_order_relaxed);
     const float currentWet = targetWetLevel.load(std::memory_order_relaxed);
@@ -58,7 +76,8 @@ void SimpleVerbWithPredelay::setPredelayTime(float predelayMs)
     const float clampedPredelay = juce::jlimit(0.0f, 500.0f, predelayMs);
     targetPredelayMs.store(clampedPredelay, std::memory_order_relaxed);
 
-    const float predelaySamples = clampedPredelay * static_cast<float>(sampleRate) / 1000.0f;
+    const float predelaySamples = juce::jmin(clampedPredelay * static_cast<float>(sampleRate) / 1000.0f,
+        static_cast<float>(maxPredelaySamples));
     predelaySmoothed.setTargetValue(predelaySamples);
 }
 
@@ -119,69 +138,99 @@ void SimpleVerbWithPredelay::setBypassed(bool shouldBeBypassed)
     bypassed.store(shouldBeBypassed, std::memory_order_relaxed);
 }
 
+void SimpleVerbWithPredelay::setEngine(Engine newEngine)
+{
+    engine.store(newEngine, std::memory_order_relaxed);
+}
+
+void SimpleVerbWithPredelay::setModulationDepth(float depth)
+{
+    targetModulationDepth.store(juce::jlimit(0.0f, 1.0f, depth), std::memory_order_relaxed);
+}
+
+bool SimpleVerbWithPredelay::loadImpulseResponse(const juce::File& file)
+{
+    return convolutionReverb.loadImpulseResponse(file);
+}
+
+void SimpleVerbWithPredelay::setNonRealtime(bool isNonRealtime)
+{
+    convolutionReverb.setNonRealtime(isNonRealtime);
+}
+
+void SimpleVerbWithPredelay::setReducedRate(bool shouldReduceRate)
+{
+    reducedRate = shouldReduceRate;
+}
+
 void SimpleVerbWithPredelay::updateReverbParameters()
 {
     if (needsReverbUpdate.load(std::memory_order_acquire))
     {
         juce::SpinLock::ScopedLockType sl(parameterLock);
         reverb.setParameters(reverbParams);
+        fdnReverb.setParameters(reverbParams);
         needsReverbUpdate.store(false, std::memory_order_release);
     }
+
+    fdnReverb.setModulationDepth(targetModulationDepth.load(std::memory_order_relaxed));
+
+    // The engine being switched in has been idle, so clear out its old tail
+    const auto requestedEngine = engine.load(std::memory_order_relaxed);
+    if (requestedEngine != activeEngine)
+    {
+        activeEngine = requestedEngine;
+        if (activeEngine == Engine::Fdn)
+            fdnReverb.reset();
+        else if (activeEngine == Engine::Convolution)
+            convolutionReverb.reset();
+        else
+            reverb.reset();
+    }
 }
 
-void SimpleVerbWithPredelay::applyPredelay(juce::dsp::AudioBlock<float>& inputBlock,
-    juce::dsp::AudioBlock<float>& outputBlock)
+void SimpleVerbWithPredelay::applyPredelay(juce::dsp::AudioBlock<float>& block)
 {
-    const int numChannels = static_cast<int>(inputBlock.getNumChannels());
-    const int numSamples = static_cast<int>(inputBlock.getNumSamples());
+    const int numChannels = static_cast<int>(block.getNumChannels());
+    const int numSamples = static_cast<int>(block.getNumSamples());
 
-    // Get current pre-delay in samples (smoothed per-block, not per-sample)
-    const float currentDelaySamples = predelaySmoothed.getNextValue();
+    // Get current pre-delay in samples (smoothed per-block, not per-sample),
+    // less what the rate conversion around the engines adds
+    const float currentDelaySamples = juce::jmax(0.0f, predelaySmoothed.getNextValue()
+                                                           - static_cast<float>(rateConverter.getLatencySamples()));
     const int delaySamplesInt = static_cast<int>(currentDelaySamples);
     const float delayFraction = currentDelaySamples - static_cast<float>(delaySamplesInt);
 
     // Write input to circular buffer
     for (int ch = 0; ch < numChannels; ++ch)
     {
-        const float* input = inputBlock.getChannelPointer(ch);
+        const float* input = block.getChannelPointer(static_cast<size_t>(ch));
         float* delayBuffer = predelayBuffer.getWritePointer(ch);
 
         for (int i = 0; i < numSamples; ++i)
-        {
-            const int writePos = (predelayWritePos + i) & (maxPredelaySamples - 1); // Fast modulo for power-of-2
-            delayBuffer[writePos] = input[i];
-        }
+            delayBuffer[(predelayWritePos + i) & predelayMask] = input[i];
     }
 
-    // Read delayed samples with Hermite interpolation
+    // Read delayed samples with Hermite interpolation back into the block;
+    // the whole block is in the buffer already, so this can run in place
     for (int ch = 0; ch < numChannels; ++ch)
     {
         const float* delayBuffer = predelayBuffer.getReadPointer(ch);
-        float* output = outputBlock.getChannelPointer(ch);
+        float* output = block.getChannelPointer(static_cast<size_t>(ch));
 
         for (int i = 0; i < numSamples; ++i)
         {
-            // Calculate read position with wrap-around
-            const int currentWritePos = (predelayWritePos + i);
-            const int readPos = currentWritePos - delaySamplesInt;
+            const int readPos = predelayWritePos + i - delaySamplesInt;
 
             // Get 4 samples for cubic interpolation
-            const int idx0 = (readPos - 1 + maxPredelaySamples) & (maxPredelaySamples - 1);
-            const int idx1 = readPos & (maxPredelaySamples - 1);
-            const int idx2 = (readPos + 1) & (maxPredelaySamples - 1);
-            const int idx3 = (readPos + 2) & (maxPredelaySamples - 1);
-
-            const float y0 = delayBuffer[idx0];
-            const float y1 = delayBuffer[idx1];
-            const float y2 = delayBuffer[idx2];
-            const float y3 = delayBuffer[idx3];
+            const float y0 = delayBuffer[(readPos - 1) & predelayMask];
+            const float y1 = delayBuffer[readPos & predelayMask];
+            const float y2 = delayBuffer[(readPos + 1) & predelayMask];
+            const float y3 = delayBuffer[(readPos + 2) & predelayMask];
 
             output[i] = hermiteInterpolation(delayFraction, y0, y1, y2, y3);
         }
     }
-
-    // Advance write position
-    predelayWritePos = (predelayWritePos + numSamples) & (maxPredelaySamples - 1);
 }
 
 inline float SimpleVerbWithPredelay::hermiteInterpolation(float x, float y0, float y1, float y2, float y3) const noexcept
@@ -202,65 +251,124 @@ void SimpleVerbWithPredelay::process(juce::dsp::AudioBlock<float>& block)
 
     updateReverbParameters();
 
+    // The pre-delay buffer is sized for the prepared block size
+    const auto numSamples = block.getNumSamples();
+    for (size_t start = 0; start < numSamples; start += static_cast<size_t>(maxBlockSize))
+    {
+        auto chunk = block.getSubBlock(start, juce::jmin(static_cast<size_t>(maxBlockSize), numSamples - start));
+        processChunk(chunk);
+    }
+}
+
+void SimpleVerbWithPredelay::processReverb(juce::dsp::AudioBlock<float>& block)
+{
+    // A short block can leave nothing to process at the reduced rate
+    if (block.getNumSamples() == 0)
+        return;
+
+    if (activeEngine == Engine::Fdn)
+    {
+        fdnReverb.process(block);
+    }
+    else if (activeEngine == Engine::Convolution)
+    {
+        convolutionReverb.process(block);
+    }
+    else
+    {
+        juce::dsp::ProcessContextReplacing<float> reverbContext(block);
+        reverb.process(reverbContext);
+    }
+}
+
+void SimpleVerbWithPredelay::processChunk(juce::dsp::AudioBlock<float>& block)
+{
     const int numChannels = static_cast<int>(block.getNumChannels());
     const int numSamples = static_cast<int>(block.getNumSamples());
 
-    // Ensure working buffer is large enough
-    if (workingBuffer.getNumSamples() < numSamples)
-        workingBuffer.setSize(numChannels, numSamples, false, false, true);
+    const bool wetSettled = ! wetLevelSmoothed.isSmoothing();
+    const float wetTarget = wetLevelSmoothed.getTargetValue();
 
-    // Apply pre-delay
-    juce::dsp::AudioBlock<float> delayedBlock(workingBuffer.getArrayOfWritePointers(),
-        numChannels, 0, numSamples);
-    applyPredelay(block, delayedBlock);
+    // Fully dry: the block passes through untouched
+    if (wetSettled && wetTarget <= 0.0f)
+    {
+        predelaySmoothed.skip(numSamples);
+        wasRendering = false;
+        return;
+    }
 
-    // Process through reverb
-    juce::dsp::ProcessContextReplacing<float> reverbContext(delayedBlock);
-    reverb.process(reverbContext);
+    // Coming back from fully dry, don't replay what was left in the buffers
+    if (! wasRendering)
+    {
+        predelayBuffer.clear();
+        rateConverter.reset();
+        reverb.reset();
+        fdnReverb.reset();
+        convolutionReverb.reset();
+        wasRendering = true;
+    }
 
-    // Mix wet/dry with smoothed wet level
-    const bool isSmoothing = wetLevelSmoothed.isSmoothing();
+    // The reverb runs in place on the block; the dry input stays in the
+    // pre-delay buffer until the mix below
+    const int dryStart = predelayWritePos;
+    applyPredelay(block);
 
-    if (isSmoothing)
+    if (rateConverter.getFactor() > 1)
+    {
+        auto reduced = rateConverter.decimate(block);
+        processReverb(reduced);
+        rateConverter.interpolate(reduced, block);
+    }
+    else
+    {
+        processReverb(block);
+    }
+
+    predelayWritePos = (predelayWritePos + numSamples) & predelayMask;
+
+    // Skip next value for predelay smoothing (already consumed in applyPredelay)
+    if (predelaySmoothed.isSmoothing())
+        predelaySmoothed.skip(numSamples - 1);
+
+    // Fully wet: the block already holds the output
+    if (wetSettled && wetTarget >= 1.0f)
+        return;
+
+    // Mix wet/dry with smoothed wet level
+    if (! wetSettled)
     {
         // Per-sample smoothing when wet level is changing
         for (int i = 0; i < numSamples; ++i)
         {
             const float wetGain = wetLevelSmoothed.getNextValue();
             const float dryGain = 1.0f - wetGain;
+            const int dryPos = (dryStart + i) & predelayMask;
 
             for (int ch = 0; ch < numChannels; ++ch)
             {
-                const float dry = block.getSample(ch, i);
-                const float wet = delayedBlock.getSample(ch, i);
-                block.setSample(ch, i, dry * dryGain + wet * wetGain);
+                float* wet = block.getChannelPointer(static_cast<size_t>(ch));
+                wet[i] = predelayBuffer.getSample(ch, dryPos) * dryGain + wet[i] * wetGain;
             }
         }
     }
     else
     {
-        // Optimized path when wet level is stable
+        // Optimized path when wet level is stable; the dry may wrap around
+        // the end of the pre-delay buffer, so it is mixed in two spans
         const float wetGain = wetLevelSmoothed.getCurrentValue();
         const float dryGain = 1.0f - wetGain;
+        const int firstSpan = juce::jmin(numSamples, predelayMask + 1 - dryStart);
 
         for (int ch = 0; ch < numChannels; ++ch)
         {
-            float* dryBuffer = block.getChannelPointer(ch);
-            const float* wetBuffer = delayedBlock.getChannelPointer(ch);
+            float* wet = block.getChannelPointer(static_cast<size_t>(ch));
+            const float* dry = predelayBuffer.getReadPointer(ch);
 
-            for (int i = 0; i < numSamples; ++i)
-            {
-                dryBuffer[i] = dryBuffer[i] * dryGain + wetBuffer[i] * wetGain;
-            }
+            juce::FloatVectorOperations::multiply(wet, wetGain, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(wet, dry + dryStart, dryGain, firstSpan);
+            juce::FloatVectorOperations::addWithMultiply(wet + firstSpan, dry, dryGain, numSamples - firstSpan);
         }
     }
-
-    // Skip next value for predelay smoothing (already consumed in applyPredelay)
-    if (predelaySmoothed.isSmoothing())
-    {
-        for (int i = 1; i < numSamples; ++i)
-            predelaySmoothed.skip(1);
-    }
 }
 
 float SimpleVerbWithPredelay::getPredelayTime() const noexcept
@@ -275,6 +383,12 @@ float SimpleVerbWithPredelay::getWetLevel() const noexcept
 
 int SimpleVerbWithPredelay::getTailLengthSamples() const noexcept
 {
+    if (getEngine() == Engine::Fdn)
+        return static_cast<int>(sampleRate * fdnReverb.getDecayTime());
+
+    if (getEngine() == Engine::Convolution)
+        return convolutionReverb.getImpulseLengthSamples() * rateConverter.getFactor();
+
     // Approximate tail length based on room size
     const float roomSize = reverbParams.roomSize;
     return static_cast<int>(sampleRate * roomSize * 2.0); // Rough estimate
@@ -1,6 +1,9 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include "FdnReverb.h"
+#include "ConvolutionReverb.h"
+#include "HalfBandResampler.h"
 
 /**
  * @brief High-quality reverb with pre-delay and smooth parameter control
@@ -11,6 +14,17 @@
 class SimpleVerbWithPredelay
 {
 public:
+    // Classic: juce::dsp::Reverb (Freeverb combs and allpasses)
+    // Fdn: eight-line feedback delay network, denser at similar cost
+    // Convolution: the loaded impulse response; size, damping, width and
+    // freeze don't apply
+    enum class Engine
+    {
+        Classic,
+        Fdn,
+        Convolution
+    };
+
     SimpleVerbWithPredelay();
     ~SimpleVerbWithPredelay() = default;
 
@@ -49,6 +63,21 @@ public:
     /** Enable/disable reverb */
     void setBypassed(bool shouldBeBypassed);
 
+    /** Selects the reverb engine; the incoming engine starts from silence */
+    void setEngine(Engine newEngine);
+
+    /** Sets the FDN delay line modulation depth (0.0 - 1.0) */
+    void setModulationDepth(float depth);
+
+    /** Loads the convolution engine's impulse response from a WAV file; call off the audio thread */
+    bool loadImpulseResponse(const juce::File& file);
+
+    /** Tells the convolution engine whether it is rendering offline, where it can't drop late blocks */
+    void setNonRealtime(bool isNonRealtime);
+
+    /** Runs the reverb engines at 44.1-48kHz when the session rate is 2x or 4x that; takes effect in prepare() */
+    void setReducedRate(bool shouldReduceRate);
+
     //==============================================================================
     /** Processes an audio block */
     void process(juce::dsp::AudioBlock<float>& block);
@@ -60,23 +89,45 @@ public:
     /** Returns current wet level */
     float getWetLevel() const noexcept;
 
+    /** Returns the selected engine */
+    Engine getEngine() const noexcept { return engine.load(std::memory_order_relaxed); }
+
     /** Returns whether bypassed */
     bool isBypassed() const noexcept { return bypassed.load(std::memory_order_relaxed); }
 
+    /** Returns whether the engines may run at a reduced rate */
+    bool isReducedRate() const noexcept { return reducedRate; }
+
+    /** Returns the factor the reverb engines' rate is reduced by */
+    int getRateReduction() const noexcept { return rateConverter.getFactor(); }
+
     /** Returns the reverb tail length in samples */
     int getTailLengthSamples() const noexcept;
 
+    /** Returns the longest pre-delay in samples at the prepared rate */
+    int getMaxPredelaySamples() const noexcept { return maxPredelaySamples; }
+
 private:
     //==============================================================================
     juce::dsp::Reverb reverb;
+    FdnReverb fdnReverb;
+    ConvolutionReverb convolutionReverb;
     juce::dsp::Reverb::Parameters reverbParams;
 
-    // Pre-delay buffer and working buffers
+    // Takes the pre-delayed signal down to the engines' rate and back; the
+    // pre-delay and the dry/wet mix stay at the session rate
+    HalfBandResampler rateConverter;
+    bool reducedRate = true;
+
+    // Pre-delay ring buffer. It also holds the current block's dry input,
+    // so the reverb can run in place on the host block
     juce::AudioBuffer<float> predelayBuffer;
-    juce::AudioBuffer<float> workingBuffer;
 
     int predelayWritePos = 0;
+    int predelayMask = 0;
     int maxPredelaySamples = 0;
+    int maxBlockSize = 0;
+    bool wasRendering = true;
     double sampleRate = 44100.0;
 
     // Smoothed parameters
@@ -86,7 +137,10 @@ private:
     // Thread-safe parameter storage
     std::atomic<float> targetPredelayMs{ 0.0f };
     std::atomic<float> targetWetLevel{ 0.3f };
+    std::atomic<float> targetModulationDepth{ 0.0f };
     std::atomic<bool> bypassed{ false };
+    std::atomic<Engine> engine{ Engine::Fdn };
+    Engine activeEngine = Engine::Fdn;
 
     mutable juce::SpinLock parameterLock;
     std::atomic<bool> needsReverbUpdate{ false };
@@ -95,8 +149,9 @@ private:
 
     //==============================================================================
     void updateReverbParameters();
-    void applyPredelay(juce::dsp::AudioBlock<float>& inputBlock,
-        juce::dsp::AudioBlock<float>& outputBlock);
+    void processChunk(juce::dsp::AudioBlock<float>& block);
+    void applyPredelay(juce::dsp::AudioBlock<float>& block);
+    void processReverb(juce::dsp::AudioBlock<float>& block);
 
     inline float hermiteInterpolation(float x, float y0, float y1, float y2, float y3) const noexcept;
 
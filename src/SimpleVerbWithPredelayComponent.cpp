@@ -9,6 +9,39 @@ SimpleVerbWithPredelayComponent::SimpleVerbWithPredelayComponent(juce::AudioProc
     knobs.emplace_back(std::make_unique<PluginLookAndFeel::KnobWithLabel>(state, "size", "Size", *this));
     knobs.emplace_back(std::make_unique<PluginLookAndFeel::KnobWithLabel>(state, "damping", "Damping", *this));
     knobs.emplace_back(std::make_unique<PluginLookAndFeel::KnobWithLabel>(state, "wet", "Wet", *this));
+
+    engineSelector.addItem("Classic", 1);
+    engineSelector.addItem("FDN", 2);
+    engineSelector.addItem("IR", 3);
+    addAndMakeVisible(engineSelector);
+    engineAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        state, "reverbEngine", engineSelector);
+
+    addAndMakeVisible(loadImpulseButton);
+    loadImpulseButton.onClick = [this]()
+    {
+        impulseChooser = std::make_unique<juce::FileChooser>("Load Impulse Response", juce::File(), "*.wav");
+        impulseChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+            [this](const juce::FileChooser& chooser)
+            {
+                const auto file = chooser.getResult();
+                if (file.existsAsFile() && onImpulseResponseChosen)
+                    onImpulseResponseChosen(file);
+            });
+    };
+
+    // Not a parameter: switching it rebuilds the engines, so it is applied
+    // from here rather than automated
+    reducedRateToggle.setButtonText("Reduced Rate");
+    reducedRateToggle.setColour(juce::ToggleButton::textColourId, PluginLookAndFeel::labelText);
+    reducedRateToggle.setColour(juce::ToggleButton::tickColourId, PluginLookAndFeel::track);
+    reducedRateToggle.setToggleState(true, juce::dontSendNotification);
+    reducedRateToggle.onClick = [this]()
+    {
+        if (onReducedRateChanged)
+            onReducedRateChanged(reducedRateToggle.getToggleState());
+    };
+    addAndMakeVisible(reducedRateToggle);
 }
 
 void SimpleVerbWithPredelayComponent::paint(juce::Graphics& g)
@@ -21,6 +54,18 @@ void SimpleVerbWithPredelayComponent::resized()
     group.setBounds(getLocalBounds());
 
     auto area = getLocalBounds().reduced(PluginLookAndFeel::margin);
+
+    // --- Engine selector + impulse loader + reduced rate ---
+    const int rowHeight = 26;
+    auto rowArea = area.removeFromTop(rowHeight);
+    engineSelector.setBounds(rowArea.removeFromLeft(90));
+    rowArea.removeFromLeft(PluginLookAndFeel::spacing / 2);
+    loadImpulseButton.setBounds(rowArea.removeFromLeft(120));
+    rowArea.removeFromLeft(PluginLookAndFeel::spacing / 2);
+    reducedRateToggle.setBounds(rowArea.removeFromLeft(120));
+
+    area.removeFromTop(PluginLookAndFeel::spacing);
+
     const int numKnobs = static_cast<int>(knobs.size());
 
     auto layout = PluginLookAndFeel::calculateKnobLayout(numKnobs, area.getWidth(), area.getHeight(), false);
@@ -57,4 +102,14 @@ void SimpleVerbWithPredelayComponent::setWet(float newValue)
 {
     if (knobs.size() > 3)
         knobs[3]->slider->setValue(newValue);
+}
+
+void SimpleVerbWithPredelayComponent::setImpulseResponseName(const juce::String& name)
+{
+    loadImpulseButton.setButtonText(name);
+}
+
+void SimpleVerbWithPredelayComponent::setReducedRate(bool shouldReduceRate)
+{
+    reducedRateToggle.setToggleState(shouldReduceRate, juce::dontSendNotification);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "PluginLookAndFeel.h"
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -21,6 +22,18 @@ public:
     void setDamping(float newValue);
     void setWet(float newValue);
 
+    /** Shows the name of the loaded impulse response on the load button */
+    void setImpulseResponseName(const juce::String& name);
+
+    /** Called with the file picked from the load button */
+    std::function<void(const juce::File&)> onImpulseResponseChosen;
+
+    /** Shows whether the engines run at the reduced rate, without calling onReducedRateChanged */
+    void setReducedRate(bool shouldReduceRate);
+
+    /** Called when the reduced-rate toggle is clicked */
+    std::function<void(bool)> onReducedRateChanged;
+
     int getMinimumWidth() const { return PluginLookAndFeel::minKnobSize + PluginLookAndFeel::margin * 2; }
     int getMinimumHeight() const { return PluginLookAndFeel::minKnobSize + PluginLookAndFeel::labelHeight + PluginLookAndFeel::margin * 2 + PluginLookAndFeel::groupLabelHeight; }
 
@@ -28,6 +41,12 @@ private:
     juce::GroupComponent group{ "simpleVerbWithPredelayGroup", "Simple Verb With Predelay" };
     std::vector<std::unique_ptr<PluginLookAndFeel::KnobWithLabel>> knobs;
 
+    juce::ComboBox engineSelector;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> engineAttachment;
+    juce::TextButton loadImpulseButton{ "Load IR..." };
+    std::unique_ptr<juce::FileChooser> impulseChooser;
+    juce::ToggleButton reducedRateToggle;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleVerbWithPredelayComponent)
 };
 
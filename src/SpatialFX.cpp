@@ -1,13 +1,55 @@
 #include "SpatialFX.h"
 
+namespace
+{
+    // One full sine cycle with a guard point for interpolation. Linear
+    // interpolation over 2048 points keeps the error below 1.2e-6.
+    struct SineTable
+    {
+        static constexpr int size = 2048;
+        std::array<float, size + 1> values{};
+
+        SineTable()
+        {
+            for (int i = 0; i <= size; ++i)
+                values[static_cast<size_t>(i)] = static_cast<float>(
+                    std::sin(juce::MathConstants<double>::twoPi * i / size));
+        }
+    };
+
+    const SineTable sineTable;
+}
+
 SpatialFX::SpatialFX()
-    : random(juce::Random(juce::Time::currentTimeMillis()))
 {
 }
 
+SpatialFX::HilbertNetwork::HilbertNetwork()
+{
+    // Olli Niemitalo's 8th-order allpass pair, coefficients stored squared.
+    // The in-phase chain carries the extra one-sample delay.
+    constexpr std::array<double, hilbertSections> inPhase{
+        0.6923878, 0.9360654322959, 0.9882295226860, 0.9987488452737 };
+    constexpr std::array<double, hilbertSections> quadrature{
+        0.4021921162426, 0.8561710882420, 0.9722909545651, 0.9952884791278 };
+
+    for (size_t section = 0; section < hilbertSections; ++section)
+    {
+        const auto i = static_cast<float>(inPhase[section] * inPhase[section]);
+        const auto q = static_cast<float>(quadrature[section] * quadrature[section]);
+        coefficients[section] = { i, q, i, q };
+    }
+}
+
 void SpatialFX::prepare(const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = static_cast<float>(spec.sampleRate);
+    maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+
+    for (auto* buffer : { &lfoBufferL, &lfoBufferR, &cosBufferL, &sinBufferL,
+                          &cosBufferR, &sinBufferR, &wetBufferL, &wetBufferR,
+                          &quadBufferL, &quadBufferR })
+        buffer->assign(static_cast<size_t>(maxBlockSize), 0.0f);
 
     // Initialize smoothed parameters
     constexpr double smoothTime = 0.02;
@@ -22,11 +64,11 @@ void SpatialFX::prepare(const juce::dsp::ProcessSpec& spec)
     params.haasDelayL.reset(sampleRate, 0.01);
     params.haasDelayR.reset(sampleRate, 0.01);
 
-    allpassL.prepare(spec);
-    allpassR.prepare(spec);
     haasDelayL.prepare(spec);
     haasDelayR.prepare(spec);
 
+    buildVelvetTables();
+
     initializeDCBlockers();
     dcBlockerL.prepare(spec);
     dcBlockerR.prepare(spec);
@@ -36,8 +78,13 @@ void SpatialFX::prepare(const juce::dsp::ProcessSpec& spec)
 
 void SpatialFX::reset()
 {
-    allpassL.reset();
-    allpassR.reset();
+    allpass.reset();
+    hilbert.reset();
+    for (auto& channel : velvet)
+    {
+        std::fill(channel.history.begin(), channel.history.end(), 0.0f);
+        channel.writePos = 0;
+    }
     haasDelayL.reset();
     haasDelayR.reset();
     dcBlockerL.reset();
@@ -45,12 +92,10 @@ void SpatialFX::reset()
 
     lfoPhaseL = 0.0f;
     lfoPhaseR = lfoPhaseOffset;
-    randomValueL = randomValueR = 0.0f;
-    randomSampleCounterL = randomSampleCounterR = 0.0f;
+    restartRandomLfos();
     lastLfoValueL = lastLfoValueR = 0.0f;
 
-    needsFilterUpdate = true;
-    lastAllpassFreq = -1.0f;
+    allpassTargetsDirty = true;
 }
 
 void SpatialFX::setPhaseAmount(float leftPhase, float rightPhase)
@@ -61,6 +106,15 @@ void SpatialFX::setPhaseAmount(float leftPhase, float rightPhase)
         juce::MathConstants<float>::pi, rightPhase));
 }
 
+void SpatialFX::setPhaseMode(PhaseMode newMode)
+{
+    if (newMode != phaseMode)
+    {
+        phaseMode = newMode;
+        hilbert.reset();
+    }
+}
+
 void SpatialFX::setLfoDepth(float depthL, float depthR)
 {
     params.lfoDepthL.setTargetValue(juce::jlimit(0.0f, juce::MathConstants<float>::pi, depthL));
@@ -97,6 +151,24 @@ void SpatialFX::setRandomUpdateRate(float hz)
     randomUpdateRateHz = juce::jlimit(1.0f, 50.0f, hz);
 }
 
+void SpatialFX::setSeed(juce::uint64 newSeed)
+{
+    random.setSeed(newSeed);
+    restartRandomLfos();
+}
+
+void SpatialFX::restartRandomLfos()
+{
+    // Both random shapes start again from the top of the sequence. The
+    // smooth one's four opening control points per channel are one draw.
+    random.reset();
+    randomValueL = randomValueR = 0.0f;
+    randomSampleCounterL = randomSampleCounterR = 0.0f;
+    smoothRandomL = smoothRandomR = SmoothRandomState{};
+    random.fillBipolar(smoothRandomL.points.data(), static_cast<int>(smoothRandomL.points.size()));
+    random.fillBipolar(smoothRandomR.points.data(), static_cast<int>(smoothRandomR.points.size()));
+}
+
 void SpatialFX::setWetDry(float newWetDry)
 {
     params.wetDry.setTargetValue(juce::jlimit(0.0f, 1.0f, newWetDry));
@@ -105,8 +177,42 @@ void SpatialFX::setWetDry(float newWetDry)
 void SpatialFX::setAllpassFrequency(float frequency)
 {
     float clampedFreq = juce::jlimit(20.0f, sampleRate * 0.45f, frequency);
-    params.allpassFreq.setTargetValue(clampedFreq);
-    needsFilterUpdate = true;
+    if (clampedFreq != params.allpassFreq.getTargetValue())
+    {
+        params.allpassFreq.setTargetValue(clampedFreq);
+        allpassTargetsDirty = true;
+    }
+}
+
+void SpatialFX::setAllpassStages(int numStages)
+{
+    const int clampedStages = juce::jlimit(1, maxAllpassStages, numStages);
+
+    // Newly enabled stages start from silence at their target coefficients
+    for (int stage = allpassStages; stage < clampedStages; ++stage)
+    {
+        const auto s = static_cast<size_t>(stage);
+        for (auto* state : { &allpass.x1, &allpass.x2, &allpass.y1, &allpass.y2 })
+            (*state)[s].fill(0.0f);
+        allpass.k1[s] = allpass.k1[0];
+        allpass.k2[s] = allpass.k2[0];
+    }
+
+    if (clampedStages != allpassStages)
+    {
+        allpassStages = clampedStages;
+        allpassTargetsDirty = true;
+    }
+}
+
+void SpatialFX::setAllpassSpread(float octaves)
+{
+    const float clampedSpread = juce::jlimit(0.0f, 2.0f, octaves);
+    if (clampedSpread != allpassSpreadOctaves)
+    {
+        allpassSpreadOctaves = clampedSpread;
+        allpassTargetsDirty = true;
+    }
 }
 
 void SpatialFX::setHaasDelayMs(float leftMs, float rightMs)
@@ -115,6 +221,24 @@ void SpatialFX::setHaasDelayMs(float leftMs, float rightMs)
     params.haasDelayR.setTargetValue(juce::jlimit(0.0f, 30.0f, rightMs));
 }
 
+void SpatialFX::setDecorrelationMode(DecorrelationMode newMode)
+{
+    if (newMode == decorrelationMode)
+        return;
+
+    // Start the velvet filters from silence rather than stale history
+    if (newMode == DecorrelationMode::VelvetNoise)
+        for (auto& channel : velvet)
+            std::fill(channel.history.begin(), channel.history.end(), 0.0f);
+
+    decorrelationMode = newMode;
+}
+
+void SpatialFX::setVelvetDensity(VelvetDensity newDensity)
+{
+    velvetDensity = newDensity;
+}
+
 void SpatialFX::initializeDCBlockers()
 {
     auto dcCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 20.0f);
@@ -122,19 +246,75 @@ void SpatialFX::initializeDCBlockers()
     *dcBlockerR.coefficients = *dcCoeffs;
 }
 
-void SpatialFX::updateFilters()
+void SpatialFX::updateAllpassTargets(int numSamples)
 {
-    const float freq = params.allpassFreq.getCurrentValue();
+    const bool smoothing = params.allpassFreq.isSmoothing();
+    const float centreFreq = params.allpassFreq.skip(numSamples);
 
-    if (std::abs(freq - lastAllpassFreq) < filterUpdateThreshold && !needsFilterUpdate)
+    if (!smoothing && !allpassTargetsDirty)
+    {
+        allpass.k1Step.fill(0.0f);
+        allpass.k2Step.fill(0.0f);
         return;
+    }
+
+    allpassTargetsDirty = false;
 
-    lastAllpassFreq = freq;
-    needsFilterUpdate = false;
+    // Closed-form second-order allpass with Q = 1/sqrt(2):
+    //   H(z) = (k2 + k1 z^-1 + z^-2) / (1 + k1 z^-1 + k2 z^-2)
+    //   k2 = -c, k1 = d (1 - c)
+    //   c = (tan(pi B / fs) - 1) / (tan(pi B / fs) + 1), B = f / Q
+    //   d = -cos(2 pi f / fs)
+    // The stability region is convex in (k1, k2), so the per-sample linear
+    // ramp between two stable targets stays stable.
+    const float nyquistLimit = sampleRate * 0.45f;
+    const float invBlock = 1.0f / static_cast<float>(numSamples);
+    const float centreStage = 0.5f * static_cast<float>(allpassStages - 1);
 
-    auto coefs = juce::dsp::IIR::Coefficients<float>::makeAllPass(sampleRate, freq);
-    *allpassL.coefficients = *coefs;
-    *allpassR.coefficients = *coefs;
+    for (int stage = 0; stage < allpassStages; ++stage)
+    {
+        const auto s = static_cast<size_t>(stage);
+        const float octaveOffset = (static_cast<float>(stage) - centreStage) * allpassSpreadOctaves;
+        const float freq = juce::jlimit(20.0f, nyquistLimit, centreFreq * std::exp2(octaveOffset));
+        const float bandwidth = juce::jmin(freq * juce::MathConstants<float>::sqrt2, nyquistLimit);
+
+        const float t = std::tan(juce::MathConstants<float>::pi * bandwidth / sampleRate);
+        const float c = (t - 1.0f) / (t + 1.0f);
+        const float d = -std::cos(juce::MathConstants<float>::twoPi * freq / sampleRate);
+
+        allpass.k1Step[s] = (d * (1.0f - c) - allpass.k1[s]) * invBlock;
+        allpass.k2Step[s] = (-c - allpass.k2[s]) * invBlock;
+    }
+}
+
+void SpatialFX::processAllpassCascade(float& left, float& right)
+{
+    std::array<float, 2> in{ left, right };
+
+    for (int stage = 0; stage < allpassStages; ++stage)
+    {
+        const auto s = static_cast<size_t>(stage);
+        const float k1 = allpass.k1[s] += allpass.k1Step[s];
+        const float k2 = allpass.k2[s] += allpass.k2Step[s];
+
+        auto& x1 = allpass.x1[s];
+        auto& x2 = allpass.x2[s];
+        auto& y1 = allpass.y1[s];
+        auto& y2 = allpass.y2[s];
+
+        for (size_t ch = 0; ch < 2; ++ch)
+        {
+            const float y = k2 * (in[ch] - y2[ch]) + k1 * (x1[ch] - y1[ch]) + x2[ch];
+            x2[ch] = x1[ch];
+            x1[ch] = in[ch];
+            y2[ch] = y1[ch];
+            y1[ch] = y;
+            in[ch] = y;
+        }
+    }
+
+    left = in[0];
+    right = in[1];
 }
 
 void SpatialFX::updateRandomLfo(bool isLeftChannel, float& counter, float& value)
@@ -143,7 +323,7 @@ void SpatialFX::updateRandomLfo(bool isLeftChannel, float& counter, float& value
 
     if (counter <= 0.0f)
     {
-        value = random.nextFloat() * 2.0f - 1.0f;
+        value = random.nextBipolar();
         counter = samplesPerUpdate;
     }
     counter -= 1.0f;
@@ -161,129 +341,469 @@ float SpatialFX::calculateTriangleWave(float phase) const
         return -4.0f + 4.0f * normalizedPhase;
 }
 
-float SpatialFX::getLfoValue(float phase, bool isLeftChannel)
+void SpatialFX::process(juce::dsp::AudioBlock<float>& block)
 {
-    switch (waveform)
+    if (block.getNumChannels() < 2)
+        return;
+
+    // Early exit if completely dry and stable
+    if (params.wetDry.getTargetValue() <= 0.0f && !params.wetDry.isSmoothing())
+        return;
+
+    auto* leftData = block.getChannelPointer(0);
+    auto* rightData = block.getChannelPointer(1);
+    const int numSamples = static_cast<int>(block.getNumSamples());
+
+    // Scratch buffers are sized for the prepared block size, so larger host
+    // blocks are split rather than reallocated on the audio thread
+    for (int start = 0; start < numSamples; start += maxBlockSize)
     {
-    case LfoWaveform::Sine:
-        return std::sin(phase);
+        const int chunk = juce::jmin(maxBlockSize, numSamples - start);
+        processChunk(leftData + start, rightData + start, chunk);
+    }
+}
 
-    case LfoWaveform::Triangle:
-        return calculateTriangleWave(phase);
+void SpatialFX::processChunk(float* leftData, float* rightData, int numSamples)
+{
+    // 1. LFO render
+    renderLfo(lfoBufferL.data(), numSamples, lfoPhaseL, params.lfoRateL, true);
+    renderLfo(lfoBufferR.data(), numSamples, lfoPhaseR, params.lfoRateR, false);
 
-    case LfoWaveform::Square:
-        return phase < juce::MathConstants<float>::pi ? 1.0f : -1.0f;
+    lastLfoValueL = lfoBufferL[static_cast<size_t>(numSamples - 1)];
+    lastLfoValueR = lfoBufferR[static_cast<size_t>(numSamples - 1)];
 
-    case LfoWaveform::Random:
-        if (isLeftChannel)
+    // 2. Phase-angle render (in place over the LFO buffers)
+    renderPhaseAngles(lfoBufferL.data(), numSamples, params.phaseL, params.lfoDepthL);
+    renderPhaseAngles(lfoBufferR.data(), numSamples, params.phaseR, params.lfoDepthR);
+
+    // 3. Rotation coefficients
+    renderRotationCoefficients(lfoBufferL.data(), cosBufferL.data(), sinBufferL.data(), numSamples);
+    renderRotationCoefficients(lfoBufferR.data(), cosBufferR.data(), sinBufferR.data(), numSamples);
+
+    auto* wetL = wetBufferL.data();
+    auto* wetR = wetBufferR.data();
+
+    if (phaseMode == PhaseMode::Hilbert)
+    {
+        // 4. Phase shift of the analytic signal, Re{(I + jQ) e^(j angle)}
+        //    wetL = IL * cosL - QL * sinL
+        //    wetR = IR * cosR - QR * sinR
+        renderAnalyticSignal(leftData, rightData, numSamples);
+
+        juce::FloatVectorOperations::multiply(wetL, cosBufferL.data(), numSamples);
+        juce::FloatVectorOperations::subtractWithMultiply(wetL, quadBufferL.data(), sinBufferL.data(), numSamples);
+        juce::FloatVectorOperations::multiply(wetR, cosBufferR.data(), numSamples);
+        juce::FloatVectorOperations::subtractWithMultiply(wetR, quadBufferR.data(), sinBufferR.data(), numSamples);
+    }
+    else
+    {
+        // 4. Rotation matrix
+        //    wetL = L * cosL - R * sinL
+        //    wetR = R * cosR + L * sinR
+        juce::FloatVectorOperations::multiply(wetL, leftData, cosBufferL.data(), numSamples);
+        juce::FloatVectorOperations::subtractWithMultiply(wetL, rightData, sinBufferL.data(), numSamples);
+        juce::FloatVectorOperations::multiply(wetR, rightData, cosBufferR.data(), numSamples);
+        juce::FloatVectorOperations::addWithMultiply(wetR, leftData, sinBufferR.data(), numSamples);
+    }
+
+    if (decorrelationMode == DecorrelationMode::VelvetNoise)
+    {
+        // 5. Velvet-noise decorrelation and DC blocking. Haas and allpass
+        //    smoothers keep running so switching back does not jump.
+        params.haasDelayL.skip(numSamples);
+        params.haasDelayR.skip(numSamples);
+        params.allpassFreq.skip(numSamples);
+        allpassTargetsDirty = true;
+
+        processVelvet(velvet[0], wetL, numSamples);
+        processVelvet(velvet[1], wetR, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            wetL[i] = dcBlockerL.processSample(wetL[i]);
+            wetR[i] = dcBlockerR.processSample(wetR[i]);
+        }
+    }
+    else
+    {
+        // Allpass coefficient targets are refreshed once per block and ramped
+        // per sample inside the cascade
+        updateAllpassTargets(numSamples);
+
+        // 5. Haas delay, allpass and DC blocking (recursive, so per sample)
+        const bool haasSmoothing = params.haasDelayL.isSmoothing() || params.haasDelayR.isSmoothing();
+        const float msToSamples = sampleRate * 0.001f;
+
+        if (!haasSmoothing)
+        {
+            haasDelayL.setDelay(params.haasDelayL.getNextValue() * msToSamples);
+            haasDelayR.setDelay(params.haasDelayR.getNextValue() * msToSamples);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
         {
-            updateRandomLfo(true, randomSampleCounterL, randomValueL);
-            return randomValueL;
+            if (haasSmoothing)
+            {
+                haasDelayL.setDelay(params.haasDelayL.getNextValue() * msToSamples);
+                haasDelayR.setDelay(params.haasDelayR.getNextValue() * msToSamples);
+            }
+
+            const float delayedL = haasDelayL.popSample(0);
+            const float delayedR = haasDelayR.popSample(0);
+            haasDelayL.pushSample(0, wetL[i]);
+            haasDelayR.pushSample(0, wetR[i]);
+
+            float filteredL = delayedL;
+            float filteredR = delayedR;
+            processAllpassCascade(filteredL, filteredR);
+
+            wetL[i] = dcBlockerL.processSample(filteredL);
+            wetR[i] = dcBlockerR.processSample(filteredR);
+        }
+    }
+
+    // 6. Equal-power crossfade
+    if (!params.wetDry.isSmoothing())
+    {
+        const float smoothedWetDry = params.wetDry.getTargetValue();
+        const float wetGain = std::sqrt(smoothedWetDry);
+        const float dryGain = std::sqrt(1.0f - smoothedWetDry);
+
+        juce::FloatVectorOperations::multiply(leftData, dryGain, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(leftData, wetL, wetGain, numSamples);
+        juce::FloatVectorOperations::multiply(rightData, dryGain, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(rightData, wetR, wetGain, numSamples);
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float smoothedWetDry = params.wetDry.getNextValue();
+            const float wetGain = std::sqrt(smoothedWetDry);
+            const float dryGain = std::sqrt(1.0f - smoothedWetDry);
+
+            leftData[i] = leftData[i] * dryGain + wetL[i] * wetGain;
+            rightData[i] = rightData[i] * dryGain + wetR[i] * wetGain;
+        }
+    }
+}
+
+void SpatialFX::renderLfo(float* dest, int numSamples, float& phase,
+    juce::LinearSmoothedValue<float>& rate, bool isLeftChannel)
+{
+    const float twoPi = juce::MathConstants<float>::twoPi;
+    const float radiansPerHz = twoPi / sampleRate;
+
+    if (waveform == LfoWaveform::Sine)
+    {
+        // Quadrature oscillator, re-synchronised to the phase accumulator at
+        // the start of every block so rounding never accumulates
+        float s = std::sin(phase);
+        float c = std::cos(phase);
+
+        if (!rate.isSmoothing())
+        {
+            const float increment = rate.getNextValue() * radiansPerHz;
+            const float ci = std::cos(increment);
+            const float si = std::sin(increment);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float ns = s * ci + c * si;
+                c = c * ci - s * si;
+                s = ns;
+                dest[i] = s;
+            }
+
+            phase += increment * static_cast<float>(numSamples);
         }
         else
         {
-            updateRandomLfo(false, randomSampleCounterR, randomValueR);
-            return randomValueR;
+            // Increments are below 0.003 rad (20 Hz), so a third-order
+            // expansion of the rotation is exact to float precision
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float increment = rate.getNextValue() * radiansPerHz;
+                const float ci = 1.0f - 0.5f * increment * increment;
+                const float si = increment - increment * increment * increment * (1.0f / 6.0f);
+
+                const float ns = s * ci + c * si;
+                c = c * ci - s * si;
+                s = ns;
+                dest[i] = s;
+                phase += increment;
+            }
+        }
+
+        phase = std::fmod(phase, twoPi);
+        return;
+    }
+
+    auto advance = [&]()
+    {
+        phase += rate.getNextValue() * radiansPerHz;
+        if (phase >= twoPi) phase -= twoPi;
+    };
+
+    switch (waveform)
+    {
+    case LfoWaveform::Triangle:
+        for (int i = 0; i < numSamples; ++i)
+        {
+            advance();
+            dest[i] = calculateTriangleWave(phase);
         }
+        break;
+
+    case LfoWaveform::Square:
+        for (int i = 0; i < numSamples; ++i)
+        {
+            advance();
+            dest[i] = phase < juce::MathConstants<float>::pi ? 1.0f : -1.0f;
+        }
+        break;
+
+    case LfoWaveform::Random:
+    {
+        float& counter = isLeftChannel ? randomSampleCounterL : randomSampleCounterR;
+        float& value = isLeftChannel ? randomValueL : randomValueR;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            advance();
+            updateRandomLfo(isLeftChannel, counter, value);
+            dest[i] = value;
+        }
+        break;
+    }
+
+    case LfoWaveform::SmoothRandom:
+    {
+        // The phase is unused, but keeps running so switching shapes
+        // preserves the L/R relationship; exact for a linear rate ramp
+        const float startRate = rate.getCurrentValue();
+        const float endRate = rate.skip(numSamples);
+        phase = std::fmod(phase + 0.5f * (startRate + endRate) * radiansPerHz
+            * static_cast<float>(numSamples), twoPi);
+
+        renderSmoothRandom(dest, numSamples, isLeftChannel ? smoothRandomL : smoothRandomR);
+        break;
+    }
 
     default:
-        return 0.0f;
+        rate.skip(numSamples);
+        juce::FloatVectorOperations::clear(dest, numSamples);
+        break;
     }
 }
 
-void SpatialFX::process(juce::dsp::AudioBlock<float>& block)
+void SpatialFX::renderSmoothRandom(float* dest, int numSamples, SmoothRandomState& state)
 {
-    if (block.getNumChannels() < 2)
-        return;
+    const float increment = randomUpdateRateHz / sampleRate;
+    auto& p = state.points;
 
-    // Early exit if completely dry and stable
-    if (params.wetDry.getTargetValue() <= 0.0f && !params.wetDry.isSmoothing())
-        return;
+    // Each run covers the rest of one segment, so the inner loop is a plain
+    // polynomial evaluation; new control points are drawn between runs
+    for (int start = 0; start < numSamples;)
+    {
+        const int run = juce::jmin(numSamples - start,
+            static_cast<int>(std::ceil((1.0f - state.position) / increment)));
 
-    auto* leftData = block.getChannelPointer(0);
-    auto* rightData = block.getChannelPointer(1);
-    const size_t numSamples = block.getNumSamples();
+        const float a = 0.5f * (-p[0] + 3.0f * p[1] - 3.0f * p[2] + p[3]);
+        const float b = p[0] - 2.5f * p[1] + 2.0f * p[2] - 0.5f * p[3];
+        const float c = 0.5f * (p[2] - p[0]);
+        const float d = p[1];
 
-    const float invSampleRate = 1.0f / sampleRate;
-    const float twoPi = juce::MathConstants<float>::twoPi;
+        for (int i = 0; i < run; ++i)
+        {
+            const float t = state.position + static_cast<float>(i) * increment;
+            dest[start + i] = ((a * t + b) * t + c) * t + d;
+        }
+
+        state.position += static_cast<float>(run) * increment;
+        start += run;
 
-    for (size_t i = 0; i < numSamples; ++i)
+        if (state.position >= 1.0f)
+        {
+            state.position -= 1.0f;
+            p = { p[1], p[2], p[3], random.nextBipolar() };
+        }
+    }
+
+    // Catmull-Rom can overshoot the control points by up to 25%
+    juce::FloatVectorOperations::clip(dest, dest, -1.0f, 1.0f, numSamples);
+}
+
+void SpatialFX::renderPhaseAngles(float* lfoInOut, int numSamples,
+    juce::LinearSmoothedValue<float>& phase, juce::LinearSmoothedValue<float>& depth)
+{
+    if (!phase.isSmoothing() && !depth.isSmoothing())
     {
-        const float dryL = leftData[i];
-        const float dryR = rightData[i];
+        // angle = phase + depth * lfo
+        juce::FloatVectorOperations::multiply(lfoInOut, depth.getTargetValue(), numSamples);
+        juce::FloatVectorOperations::add(lfoInOut, phase.getTargetValue(), numSamples);
+        return;
+    }
 
-        // Get smoothed parameters
-        const float smoothedPhaseL = params.phaseL.getNextValue();
-        const float smoothedPhaseR = params.phaseR.getNextValue();
-        const float smoothedDepthL = params.lfoDepthL.getNextValue();
-        const float smoothedDepthR = params.lfoDepthR.getNextValue();
-        const float smoothedWetDry = params.wetDry.getNextValue();
-        const float haasTimeL = params.haasDelayL.getNextValue();
-        const float haasTimeR = params.haasDelayR.getNextValue();
-        const float rateL = params.lfoRateL.getNextValue();
-        const float rateR = params.lfoRateR.getNextValue();
+    for (int i = 0; i < numSamples; ++i)
+        lfoInOut[i] = phase.getNextValue() + depth.getNextValue() * lfoInOut[i];
+}
 
-        // Update filters only when needed
-        params.allpassFreq.getNextValue(); // Consume the value
-        if (needsFilterUpdate)
-            updateFilters();
+void SpatialFX::renderRotationCoefficients(const float* angles, float* cosOut, float* sinOut, int numSamples)
+{
+    const auto& table = sineTable.values;
+    constexpr float tableScale = static_cast<float>(SineTable::size) / juce::MathConstants<float>::twoPi;
+    constexpr int mask = SineTable::size - 1;
+    constexpr int quarterTurn = SineTable::size / 4;
 
-        // Update LFO phases
-        lfoPhaseL += twoPi * rateL * invSampleRate;
-        lfoPhaseR += twoPi * rateR * invSampleRate;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float position = angles[i] * tableScale;
+        const float floored = std::floor(position);
+        const float frac = position - floored;
+        const int index = static_cast<int>(floored);
 
-        if (lfoPhaseL >= twoPi) lfoPhaseL -= twoPi;
-        if (lfoPhaseR >= twoPi) lfoPhaseR -= twoPi;
+        // Two's-complement masking also wraps negative angles
+        const int s0 = index & mask;
+        const int c0 = (index + quarterTurn) & mask;
 
-        // Calculate LFO modulation
-        const float lfoModL = getLfoValue(lfoPhaseL, true);
-        const float lfoModR = getLfoValue(lfoPhaseR, false);
+        sinOut[i] = table[static_cast<size_t>(s0)] + frac * (table[static_cast<size_t>(s0 + 1)] - table[static_cast<size_t>(s0)]);
+        cosOut[i] = table[static_cast<size_t>(c0)] + frac * (table[static_cast<size_t>(c0 + 1)] - table[static_cast<size_t>(c0)]);
+    }
+}
 
-        lastLfoValueL = lfoModL;
-        lastLfoValueR = lfoModR;
+void SpatialFX::renderAnalyticSignal(const float* left, const float* right, int numSamples)
+{
+    // Writes the in-phase parts to the wet buffers and the quadrature parts
+    // to the quad buffers. Fixed cost: 16 sections per stereo sample.
+    auto* outIL = wetBufferL.data();
+    auto* outQL = quadBufferL.data();
+    auto* outIR = wetBufferR.data();
+    auto* outQR = quadBufferR.data();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        HilbertNetwork::Lanes in{ left[i], left[i], right[i], right[i] };
 
-        // Apply modulation to phase
-        const float phaseL = smoothedPhaseL + smoothedDepthL * lfoModL;
-        const float phaseR = smoothedPhaseR + smoothedDepthR * lfoModR;
+        for (size_t section = 0; section < hilbertSections; ++section)
+        {
+            const auto& a = hilbert.coefficients[section];
+            auto& x1 = hilbert.x1[section];
+            auto& x2 = hilbert.x2[section];
+            auto& y1 = hilbert.y1[section];
+            auto& y2 = hilbert.y2[section];
+
+            // y[n] = a^2 (x[n] + y[n-2]) - x[n-2]
+            for (size_t lane = 0; lane < hilbertLanes; ++lane)
+            {
+                const float y = a[lane] * (in[lane] + y2[lane]) - x2[lane];
+                x2[lane] = x1[lane];
+                x1[lane] = in[lane];
+                y2[lane] = y1[lane];
+                y1[lane] = y;
+                in[lane] = y;
+            }
+        }
+
+        outIL[i] = hilbert.inPhaseDelay[0];
+        outQL[i] = in[1];
+        outIR[i] = hilbert.inPhaseDelay[2];
+        outQR[i] = in[3];
+        hilbert.inPhaseDelay = in;
+    }
+}
+
+void SpatialFX::buildVelvetTables()
+{
+    // Velvet noise: one +-1 pulse at a random position inside each grid
+    // cell of fs / density samples, under an exponential envelope that
+    // falls 60 dB over the filter length. The first pulse of each table is
+    // pinned to zero delay to keep transients sharp. Fixed seeds make the
+    // tables identical on every prepare(); each table's jitters and signs
+    // are drawn as two blocks.
+    constexpr std::array<float, numVelvetDensities> pulsesPerSecond{ 1000.0f, 2000.0f, 4000.0f };
+    const int length = juce::jmax(1, juce::roundToInt(sampleRate * velvetLengthMs * 0.001f));
+    std::vector<float> jitters;
+
+    for (size_t ch = 0; ch < velvet.size(); ++ch)
+    {
+        DeterministicRandom tableRandom(DeterministicRandom::defaultSeed + ch);
 
-        // Phase rotation
-        const float cosL = std::cos(phaseL);
-        const float sinL = std::sin(phaseL);
-        const float cosR = std::cos(phaseR);
-        const float sinR = std::sin(phaseR);
+        for (size_t d = 0; d < numVelvetDensities; ++d)
+        {
+            auto& table = velvet[ch].tables[d];
+            const float gridSize = juce::jmax(1.0f, sampleRate / pulsesPerSecond[d]);
+            const int numTaps = juce::jmax(1, static_cast<int>(static_cast<float>(length) / gridSize));
+
+            table.delays.resize(static_cast<size_t>(numTaps));
+            table.gains.resize(static_cast<size_t>(numTaps));
+            jitters.resize(static_cast<size_t>(numTaps));
+
+            tableRandom.fillUniform(jitters.data(), numTaps);
+            tableRandom.fillBipolar(table.gains.data(), numTaps);
+
+            double energy = 0.0;
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                const auto t = static_cast<size_t>(tap);
+                const float jitter = tap == 0 ? 0.0f : jitters[t] * (gridSize - 1.0f);
+                const int delay = juce::jmin(length - 1,
+                    static_cast<int>(static_cast<float>(tap) * gridSize + jitter));
+                const float envelope = std::pow(10.0f, -3.0f * static_cast<float>(delay) / static_cast<float>(length));
+                const float sign = table.gains[t] >= 0.0f ? 1.0f : -1.0f;
+
+                table.delays[t] = delay;
+                table.gains[t] = sign * envelope;
+                energy += static_cast<double>(envelope) * envelope;
+            }
+
+            // Unit energy gain, so the wet level matches the other mode
+            const auto norm = static_cast<float>(1.0 / std::sqrt(energy));
+            juce::FloatVectorOperations::multiply(table.gains.data(), norm, numTaps);
+        }
+    }
 
-        const float shiftedL = dryL * cosL - dryR * sinL;
-        const float shiftedR = dryR * cosR + dryL * sinR;
+    velvetHistorySize = juce::nextPowerOfTwo(length + maxBlockSize);
 
-        // Haas effect
-        haasDelayL.setDelay(haasTimeL * sampleRate * 0.001f);
-        haasDelayR.setDelay(haasTimeR * sampleRate * 0.001f);
+    for (auto& channel : velvet)
+    {
+        channel.history.assign(static_cast<size_t>(velvetHistorySize) * 2, 0.0f);
+        channel.writePos = 0;
+    }
+}
 
-        const float delayedL = haasDelayL.popSample(0);
-        const float delayedR = haasDelayR.popSample(0);
-        haasDelayL.pushSample(0, shiftedL);
-        haasDelayR.pushSample(0, shiftedR);
+void SpatialFX::processVelvet(VelvetChannel& channel, float* data, int numSamples)
+{
+    const int mask = velvetHistorySize - 1;
+    auto* history = channel.history.data();
 
-        // Allpass filtering
-        float filteredL = allpassL.processSample(delayedL);
-        float filteredR = allpassR.processSample(delayedR);
+    // Mirrored write: the input lands at [pos, pos + n) in both halves
+    const int firstPart = juce::jmin(numSamples, velvetHistorySize - channel.writePos);
+    for (int offset : { 0, velvetHistorySize })
+    {
+        std::copy(data, data + firstPart, history + channel.writePos + offset);
+        std::copy(data + firstPart, data + numSamples, history + offset);
+    }
 
-        // DC blocking
-        filteredL = dcBlockerL.processSample(filteredL);
-        filteredR = dcBlockerR.processSample(filteredR);
+    // Gather-add: every tap is one contiguous scaled add of the history
+    const auto& table = channel.tables[static_cast<size_t>(velvetDensity)];
+    const int numTaps = static_cast<int>(table.delays.size());
 
-        // Equal-power crossfade
-        const float wetGain = std::sqrt(smoothedWetDry);
-        const float dryGain = std::sqrt(1.0f - smoothedWetDry);
+    juce::FloatVectorOperations::clear(data, numSamples);
 
-        leftData[i] = dryL * dryGain + filteredL * wetGain;
-        rightData[i] = dryR * dryGain + filteredR * wetGain;
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        const auto t = static_cast<size_t>(tap);
+        const int readPos = (channel.writePos - table.delays[t]) & mask;
+        juce::FloatVectorOperations::addWithMultiply(data, history + readPos, table.gains[t], numSamples);
     }
+
+    channel.writePos = (channel.writePos + numSamples) & mask;
 }
 
 bool SpatialFX::isValidWaveform(LfoWaveform wf) const
 {
     int wfValue = static_cast<int>(wf);
     return wfValue >= static_cast<int>(LfoWaveform::Sine) &&
-        wfValue <= static_cast<int>(LfoWaveform::Random);
+        wfValue <= static_cast<int>(LfoWaveform::SmoothRandom);
 }
\ No newline at end of file
@@ -1,10 +1,21 @@
 #pragma once
-#include <juce_gui_extra/juce_gui_extra.h>
 #include <juce_dsp/juce_dsp.h>
+#include "DeterministicRandom.h"
+#include <array>
+#include <vector>
 
 class SpatialFX {
 public:
-    enum class LfoWaveform { Sine = 1, Triangle, Square, Random };
+    enum class LfoWaveform { Sine = 1, Triangle, Square, Random, SmoothRandom };
+
+    // Rotation cross-mixes L and R; Hilbert shifts each channel's own phase
+    // by the same angle at every frequency
+    enum class PhaseMode { Rotation, Hilbert };
+
+    // Widening after the phase stage: Haas delay plus allpass cascade, or a
+    // pair of velvet-noise sparse FIRs that stay mono-compatible
+    enum class DecorrelationMode { HaasAllpass, VelvetNoise };
+    enum class VelvetDensity { Sparse, Medium, Dense }; // 1000, 2000, 4000 pulses/s
 
     SpatialFX();
     void prepare(const juce::dsp::ProcessSpec& spec);
@@ -12,18 +23,24 @@ public:
 
     // Phase manipulation (in radians, pi range)
     void setPhaseAmount(float leftPhase, float rightPhase);
+    void setPhaseMode(PhaseMode newMode);
 
     // LFO controls
     void setLfoDepth(float depthL, float depthR); // 0 to pi radians
     void setLfoRate(float rateL, float rateR); // 0 to 20 Hz
     void setLfoWaveform(LfoWaveform waveform);
     void setLfoPhaseOffset(float offset); // 0 to 2pi, phase relationship between L/R
-    void setRandomUpdateRate(float hz); // For random waveform, 1-50 Hz
+    void setRandomUpdateRate(float hz); // For random waveforms, 1-50 Hz
+    void setSeed(juce::uint64 newSeed); // Restarts the random LFO sequence
 
     // Mix and filtering
     void setWetDry(float newWetDry); // 0 to 1
     void setAllpassFrequency(float frequency); // Hz
+    void setAllpassStages(int numStages); // 1 to 8 cascaded sections
+    void setAllpassSpread(float octaves); // 0 to 2 octaves between adjacent stages
     void setHaasDelayMs(float leftMs, float rightMs); // 0 to 30ms
+    void setDecorrelationMode(DecorrelationMode newMode);
+    void setVelvetDensity(VelvetDensity newDensity);
 
     // Processing
     void process(juce::dsp::AudioBlock<float>& block);
@@ -32,6 +49,7 @@ public:
     float getCurrentLfoValueL() const { return lastLfoValueL; }
     float getCurrentLfoValueR() const { return lastLfoValueR; }
     LfoWaveform getCurrentWaveform() const { return waveform; }
+    PhaseMode getPhaseMode() const { return phaseMode; }
 
 private:
     struct SpatialParameters {
@@ -74,30 +92,132 @@ private:
     float randomSampleCounterL = 0.0f;
     float randomSampleCounterR = 0.0f;
     float randomUpdateRateHz = 10.0f;
-    juce::Random random;
+
+    // Smooth random: Catmull-Rom interpolation through random control
+    // points drawn at the update rate. points[1] -> points[2] is the segment
+    // being played, position its progress in [0, 1).
+    struct SmoothRandomState
+    {
+        std::array<float, 4> points{};
+        float position = 0.0f;
+    };
+
+    SmoothRandomState smoothRandomL, smoothRandomR;
+    DeterministicRandom random;
+
+    // Cascade of second-order allpass sections. Coefficients are shared by
+    // both channels; state is laid out [stage][channel] so the channel loop
+    // runs as one vector operation per stage.
+    static constexpr int maxAllpassStages = 8;
+
+    struct AllpassCascade
+    {
+        std::array<float, maxAllpassStages> k1{}, k2{};
+        std::array<float, maxAllpassStages> k1Step{}, k2Step{};
+        std::array<std::array<float, 2>, maxAllpassStages> x1{}, x2{}, y1{}, y2{};
+
+        void reset()
+        {
+            for (auto* state : { &x1, &x2, &y1, &y2 })
+                for (auto& stage : *state)
+                    stage.fill(0.0f);
+        }
+    };
+
+    // Polyphase IIR Hilbert transformer: two chains of four first-order
+    // allpass sections in z^-2 whose outputs stay 90 degrees apart from
+    // roughly 20 Hz to 22 kHz at 44.1 kHz. Lanes are { L_I, L_Q, R_I, R_Q }
+    // so every section is one 4-wide vector operation.
+    static constexpr int hilbertSections = 4;
+    static constexpr int hilbertLanes = 4;
+
+    struct HilbertNetwork
+    {
+        using Lanes = std::array<float, hilbertLanes>;
+
+        std::array<Lanes, hilbertSections> coefficients{};
+        std::array<Lanes, hilbertSections> x1{}, x2{}, y1{}, y2{};
+        Lanes inPhaseDelay{};
+
+        HilbertNetwork();
+
+        void reset()
+        {
+            for (auto* state : { &x1, &x2, &y1, &y2 })
+                for (auto& section : *state)
+                    section.fill(0.0f);
+            inPhaseDelay.fill(0.0f);
+        }
+    };
+
+    PhaseMode phaseMode = PhaseMode::Rotation;
+    HilbertNetwork hilbert;
+
+    // Velvet-noise decorrelator. One tap table per density and channel is
+    // generated in prepare(); the input history is mirrored (every sample
+    // is written at pos and pos + size) so each tap reads one contiguous run.
+    static constexpr int numVelvetDensities = 3;
+    static constexpr float velvetLengthMs = 30.0f;
+
+    struct VelvetTable
+    {
+        std::vector<int> delays;
+        std::vector<float> gains;
+    };
+
+    struct VelvetChannel
+    {
+        std::array<VelvetTable, numVelvetDensities> tables;
+        std::vector<float> history;
+        int writePos = 0;
+    };
+
+    DecorrelationMode decorrelationMode = DecorrelationMode::HaasAllpass;
+    VelvetDensity velvetDensity = VelvetDensity::Medium;
+    std::array<VelvetChannel, 2> velvet;
+    int velvetHistorySize = 0;
+
+    AllpassCascade allpass;
+    int allpassStages = 1;
+    float allpassSpreadOctaves = 1.0f;
+    bool allpassTargetsDirty = true;
 
     // DSP components
-    juce::dsp::IIR::Filter<float> allpassL;
-    juce::dsp::IIR::Filter<float> allpassR;
     juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> haasDelayL{ 4410 };
     juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> haasDelayR{ 4410 };
 
-    // Filter management
-    float lastAllpassFreq = -1.0f;
-    bool needsFilterUpdate = true;
-    static constexpr float filterUpdateThreshold = 0.5f;
+    // Block scratch buffers, sized in prepare()
+    std::vector<float> lfoBufferL, lfoBufferR;      // LFO, then phase angle
+    std::vector<float> cosBufferL, sinBufferL;
+    std::vector<float> cosBufferR, sinBufferR;
+    std::vector<float> wetBufferL, wetBufferR;     // In-phase output in Hilbert mode
+    std::vector<float> quadBufferL, quadBufferR;   // Hilbert mode only
+    int maxBlockSize = 0;
 
     // DC blocking for safety
     juce::dsp::IIR::Filter<float> dcBlockerL;
     juce::dsp::IIR::Filter<float> dcBlockerR;
 
     // Helper methods
-    void updateFilters();
+    void updateAllpassTargets(int numSamples);
+    void processAllpassCascade(float& left, float& right);
     void updateRandomLfo(bool isLeftChannel, float& counter, float& value);
-    float getLfoValue(float phase, bool isLeftChannel);
     float calculateTriangleWave(float phase) const;
     bool isValidWaveform(LfoWaveform wf) const;
     void initializeDCBlockers();
 
+    // Block pipeline stages
+    void processChunk(float* left, float* right, int numSamples);
+    void renderLfo(float* dest, int numSamples, float& phase,
+        juce::LinearSmoothedValue<float>& rate, bool isLeftChannel);
+    void renderSmoothRandom(float* dest, int numSamples, SmoothRandomState& state);
+    void restartRandomLfos();
+    static void renderPhaseAngles(float* lfoInOut, int numSamples,
+        juce::LinearSmoothedValue<float>& phase, juce::LinearSmoothedValue<float>& depth);
+    static void renderRotationCoefficients(const float* angles, float* cosOut, float* sinOut, int numSamples);
+    void renderAnalyticSignal(const float* left, const float* right, int numSamples);
+    void buildVelvetTables();
+    void processVelvet(VelvetChannel& channel, float* data, int numSamples);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpatialFX)
 };
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "ExciterSaturation.h"
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int fftOrder = 13;
+    constexpr int fftSize = 1 << fftOrder;
+    constexpr float toneAmplitude = 0.8f;
+
+    // Stepped sweep from 1kHz to 10kHz. Every tone sits on an odd FFT bin,
+    // so its harmonics and their aliases all land on exact bins and only the
+    // harmonics fall on multiples of the tone's bin.
+    constexpr int sweepBins[] = { 171, 341, 683, 1023, 1365, 1707 };
+
+    struct SpectrumEnergy
+    {
+        double harmonic = 0.0;
+        double alias = 0.0;
+    };
+
+    // Plays one tone until the filters settle, then splits the spectrum of
+    // the last fftSize output samples into harmonics of the tone and the rest
+    SpectrumEnergy measureTone(ExciterSaturation& exciter, int toneBin)
+    {
+        exciter.reset();
+
+        const int settleSamples = static_cast<int>(sampleRate / 2.0);
+        const int totalSamples = settleSamples + fftSize;
+        juce::AudioBuffer<float> buffer(2, totalSamples);
+
+        for (int i = 0; i < totalSamples; ++i)
+        {
+            const float x = toneAmplitude * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * toneBin * i / fftSize));
+            buffer.setSample(0, i, x);
+            buffer.setSample(1, i, x);
+        }
+
+        juce::dsp::AudioBlock<float> block(buffer);
+        for (int start = 0; start < totalSamples; start += blockSize)
+        {
+            auto subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(juce::jmin(blockSize, totalSamples - start)));
+            exciter.process(subBlock);
+        }
+
+        std::vector<float> fftData(2 * fftSize, 0.0f);
+        std::copy_n(buffer.getReadPointer(0, settleSamples), fftSize, fftData.begin());
+
+        juce::dsp::FFT fft(fftOrder);
+        fft.performRealOnlyForwardTransform(fftData.data());
+
+        // The lowest bins hold what is left of the DC blocker's settling
+        SpectrumEnergy energy;
+        for (int bin = 4; bin < fftSize / 2; ++bin)
+        {
+            const double re = fftData[static_cast<size_t>(2 * bin)];
+            const double im = fftData[static_cast<size_t>(2 * bin + 1)];
+            const double power = re * re + im * im;
+
+            if (bin % toneBin == 0)
+                energy.harmonic += power;
+            else
+                energy.alias += power;
+        }
+
+        return energy;
+    }
+
+    // Alias energy relative to the harmonic energy over the whole sweep, in dB
+    double measureSweep(ExciterSaturation::SaturationType type, ExciterSaturation::Antialiasing antialiasing, int oversamplingFactor)
+    {
+        ExciterSaturation exciter;
+        exciter.setDrive(0.25f);
+        exciter.setMix(1.0f);
+        exciter.setHighpass(20.0f);
+        exciter.setToneBrightness(0.0f);
+        exciter.setHarmonicBalance(0.5f);
+        exciter.setSaturationType(type);
+        exciter.setHarmonicMode(ExciterSaturation::HarmonicMode::Balanced);
+        exciter.setAutoGainEnabled(false);
+        exciter.setAntialiasing(antialiasing);
+        exciter.setOversamplingFactor(oversamplingFactor);
+        exciter.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 2 });
+
+        SpectrumEnergy total;
+        for (const int bin : sweepBins)
+        {
+            const auto energy = measureTone(exciter, bin);
+            total.harmonic += energy.harmonic;
+            total.alias += energy.alias;
+        }
+
+        return 10.0 * std::log10(total.alias / total.harmonic);
+    }
+
+    // Plays one quiet tone, so the shaper stays on the straight part of its
+    // curve, and returns the output's component at the tone's bin
+    std::complex<double> measureResponse(ExciterSaturation::Antialiasing antialiasing, int oversamplingFactor,
+        float mix, int toneBin)
+    {
+        ExciterSaturation exciter;
+        exciter.setDrive(0.0f);
+        exciter.setMix(mix);
+        exciter.setHighpass(20.0f);
+        exciter.setToneBrightness(0.0f);
+        exciter.setHarmonicBalance(0.5f);
+        exciter.setSaturationType(ExciterSaturation::SaturationType::Soft);
+        exciter.setAutoGainEnabled(false);
+        exciter.setAntialiasing(antialiasing);
+        exciter.setOversamplingFactor(oversamplingFactor);
+        exciter.setOversamplingFilter(ExciterSaturation::OversamplingFilter::LinearPhaseFIR);
+        exciter.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 2 });
+
+        const int settleSamples = static_cast<int>(sampleRate / 2.0);
+        const int totalSamples = settleSamples + fftSize;
+        juce::AudioBuffer<float> buffer(2, totalSamples);
+
+        for (int i = 0; i < totalSamples; ++i)
+        {
+            const float x = 0.05f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * toneBin * i / fftSize));
+            buffer.setSample(0, i, x);
+            buffer.setSample(1, i, x);
+        }
+
+        juce::dsp::AudioBlock<float> block(buffer);
+        for (int start = 0; start < totalSamples; start += blockSize)
+        {
+            auto subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(juce::jmin(blockSize, totalSamples - start)));
+            exciter.process(subBlock);
+        }
+
+        std::complex<double> response;
+        for (int i = 0; i < fftSize; ++i)
+            response += static_cast<double>(buffer.getSample(0, settleSamples + i))
+                * std::polar(1.0, -juce::MathConstants<double>::twoPi * toneBin * i / fftSize);
+
+        return response;
+    }
+}
+
+//==============================================================================
+class ExciterSaturationAliasingTest : public juce::UnitTest
+{
+public:
+    ExciterSaturationAliasingTest() : juce::UnitTest("ExciterSaturation aliasing", "EchoPsychFX") {}
+
+    void runTest() override
+    {
+        using SaturationType = ExciterSaturation::SaturationType;
+        using Antialiasing = ExciterSaturation::Antialiasing;
+
+        // Second-order ADAA without oversampling has to come within 3dB of
+        // plain 2x oversampling, and clearly beat the naive shaper at 1x
+        constexpr double marginToOversampledDb = 3.0;
+        constexpr double minImprovementDb = 10.0;
+
+        const std::pair<SaturationType, const char*> types[] = {
+            { SaturationType::Soft, "Soft" },
+            { SaturationType::Tube, "Tube" },
+            { SaturationType::Tape, "Tape" }
+        };
+
+        for (const auto& [type, name] : types)
+        {
+            beginTest(juce::String(name) + ": ADAA2 at 1x against the 2x path");
+
+            const double naive = measureSweep(type, Antialiasing::Off, 1);
+            const double adaa = measureSweep(type, Antialiasing::SecondOrder, 1);
+            const double oversampled = measureSweep(type, Antialiasing::Off, 2);
+
+            logMessage("alias/harmonic energy: 1x " + juce::String(naive, 1) + " dB, 1x ADAA2 "
+                + juce::String(adaa, 1) + " dB, 2x " + juce::String(oversampled, 1) + " dB");
+
+            expectLessThan(adaa, oversampled + marginToOversampledDb, "ADAA2 at 1x is not within 3dB of 2x oversampling");
+            expectLessThan(adaa, naive - minImprovementDb, "ADAA2 at 1x does not improve on the naive shaper");
+        }
+    }
+};
+
+static ExciterSaturationAliasingTest exciterSaturationAliasingTest;
+
+//==============================================================================
+class ExciterSaturationAlignmentTest : public juce::UnitTest
+{
+public:
+    ExciterSaturationAlignmentTest() : juce::UnitTest("ExciterSaturation dry/wet alignment", "EchoPsychFX") {}
+
+    void runTest() override
+    {
+        using Antialiasing = ExciterSaturation::Antialiasing;
+
+        // At mix 0.5 the output is the equal-power sum of the dry and wet.
+        // In phase, its level is the sum of theirs; any offset between them
+        // combs it down, by 2dB at 12kHz for the one sample of ADAA2
+        constexpr double maxCombLossDb = 0.1;
+        constexpr int toneBins[] = { 683, 1365, 2047 };     // 4kHz, 8kHz, 12kHz
+
+        const std::pair<Antialiasing, const char*> settings[] = {
+            { Antialiasing::Off, "Off" },
+            { Antialiasing::FirstOrder, "ADAA1" },
+            { Antialiasing::SecondOrder, "ADAA2" }
+        };
+
+        for (const auto& [antialiasing, name] : settings)
+        {
+            beginTest(juce::String(name) + " at 1x, mix 0.5");
+
+            for (const int bin : toneBins)
+            {
+                const double dry = std::abs(measureResponse(antialiasing, 1, 0.0f, bin));
+                const double wet = std::abs(measureResponse(antialiasing, 1, 1.0f, bin));
+                const double mixed = std::abs(measureResponse(antialiasing, 1, 0.5f, bin));
+
+                const double inPhase = std::sqrt(0.5) * (dry + wet);
+                const double lossDb = 20.0 * std::log10(inPhase / mixed);
+
+                logMessage(juce::String(bin * sampleRate / fftSize, 0) + " Hz: comb loss " + juce::String(lossDb, 2) + " dB");
+                expectLessThan(lossDb, maxCombLossDb, "dry and wet are out of line");
+            }
+        }
+    }
+};
+
+static ExciterSaturationAlignmentTest exciterSaturationAlignmentTest;
+
+//==============================================================================
+class ExciterSaturationChebyshevTest : public juce::UnitTest
+{
+public:
+    ExciterSaturationChebyshevTest() : juce::UnitTest("ExciterSaturation Chebyshev harmonics", "EchoPsychFX") {}
+
+    void runTest() override
+    {
+        // Distinct levels of both signs, one order left out
+        constexpr float gains[] = { 0.3f, -0.2f, 0.1f, 0.05f, 0.0f, -0.15f, 0.02f };
+        constexpr int toneBin = 171;        // 1kHz, so harmonic 8 stays well below Nyquist at 1x
+        constexpr double tolerance = 0.002;
+
+        beginTest("Per-order levels for a full-scale sine at full drive");
+        {
+            ExciterSaturation exciter;
+            exciter.setDrive(1.0f);
+            exciter.setMix(1.0f);
+            exciter.setHighpass(20.0f);
+            exciter.setToneBrightness(0.0f);
+            exciter.setHarmonicBalance(0.5f);
+            exciter.setHarmonicMode(ExciterSaturation::HarmonicMode::Chebyshev);
+            exciter.setAutoGainEnabled(false);
+            exciter.setOversamplingFactor(1);
+
+            for (int order = 2; order <= ExciterSaturation::maxChebyshevOrder; ++order)
+                exciter.setChebyshevGain(order, gains[order - 2]);
+
+            exciter.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 2 });
+
+            const int settleSamples = static_cast<int>(sampleRate / 2.0);
+            const int totalSamples = settleSamples + fftSize;
+            juce::AudioBuffer<float> buffer(2, totalSamples);
+
+            for (int i = 0; i < totalSamples; ++i)
+            {
+                const float x = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * toneBin * i / fftSize));
+                buffer.setSample(0, i, x);
+                buffer.setSample(1, i, x);
+            }
+
+            juce::dsp::AudioBlock<float> block(buffer);
+            for (int start = 0; start < totalSamples; start += blockSize)
+            {
+                auto subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(juce::jmin(blockSize, totalSamples - start)));
+                exciter.process(subBlock);
+            }
+
+            // Peak amplitude at each harmonic's bin
+            auto levelAt = [&](int bin)
+            {
+                std::complex<double> sum;
+                for (int i = 0; i < fftSize; ++i)
+                    sum += static_cast<double>(buffer.getSample(0, settleSamples + i))
+                        * std::polar(1.0, -juce::MathConstants<double>::twoPi * bin * i / fftSize);
+
+                return 2.0 * std::abs(sum) / fftSize;
+            };
+
+            expectWithinAbsoluteError(levelAt(toneBin), 1.0, tolerance, "the fundamental changed");
+
+            for (int order = 2; order <= ExciterSaturation::maxChebyshevOrder; ++order)
+            {
+                const double level = levelAt(order * toneBin);
+                logMessage("harmonic " + juce::String(order) + ": " + juce::String(level, 4)
+                    + " (set to " + juce::String(gains[order - 2], 2) + ")");
+                expectWithinAbsoluteError(level, static_cast<double>(std::abs(gains[order - 2])), tolerance,
+                    "harmonic " + juce::String(order) + " is off its level");
+            }
+        }
+
+        beginTest("Recommended oversampling follows the highest order");
+        {
+            ExciterSaturation exciter;
+            exciter.setHarmonicMode(ExciterSaturation::HarmonicMode::Chebyshev);
+
+            for (int order = 2; order <= ExciterSaturation::maxChebyshevOrder; ++order)
+                exciter.setChebyshevGain(order, order == 2 ? 0.3f : 0.0f);
+            expectEquals(exciter.getRecommendedOversamplingFactor(), 1, "order 2 alone needs no oversampling");
+
+            exciter.setChebyshevGain(3, 0.1f);
+            expectEquals(exciter.getRecommendedOversamplingFactor(), 2);
+
+            exciter.setChebyshevGain(8, 0.1f);
+            expectEquals(exciter.getRecommendedOversamplingFactor(), 4);
+        }
+    }
+};
+
+static ExciterSaturationChebyshevTest exciterSaturationChebyshevTest;
@@ -0,0 +1,72 @@
+#include "MicroPitchDetune.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+//==============================================================================
+// Per-sample cost of the granular engine against the modulated tap engine.
+// The granular engine runs one shifter per channel whatever the voice count,
+// so its cost should stay flat while the tap engine's grows with the voices.
+class MicroPitchDetuneEngineBenchmark : public juce::UnitTest
+{
+public:
+    MicroPitchDetuneEngineBenchmark() : juce::UnitTest("MicroPitchDetune engine cost", "EchoPsychFX Benchmarks") {}
+
+    void runTest() override
+    {
+        for (const int numVoices : { 1, 3, 8 })
+        {
+            beginTest(juce::String(numVoices) + " voices: Granular against Modulated");
+
+            const double modulated = measureNanosecondsPerSample(MicroPitchDetune::Engine::Modulated, numVoices);
+            const double granular = measureNanosecondsPerSample(MicroPitchDetune::Engine::Granular, numVoices);
+
+            logMessage("ns per stereo sample: modulated " + juce::String(modulated, 1) + ", granular "
+                + juce::String(granular, 1) + " (" + juce::String(granular / modulated, 2) + "x)");
+
+            expect(std::isfinite(modulated) && std::isfinite(granular));
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int numBlocks = 2000;
+    static constexpr int numRuns = 5;
+
+    // Best of several runs, so a preempted run doesn't count
+    static double measureNanosecondsPerSample(MicroPitchDetune::Engine engine, int numVoices)
+    {
+        MicroPitchDetune detune;
+        detune.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 2 });
+        detune.setEngine(engine);
+        detune.setNumVoices(numVoices);
+        detune.setParams(15.0f, 0.7f, 0.004f, 0.006f, 0.5f, 0.5f, 0.3f, 0.6f);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (int i = 0; i < blockSize; ++i)
+        {
+            buffer.setSample(0, i, 0.5f * std::sin(0.05f * static_cast<float>(i)));
+            buffer.setSample(1, i, 0.5f * std::sin(0.031f * static_cast<float>(i)));
+        }
+
+        double best = std::numeric_limits<double>::max();
+        for (int run = 0; run < numRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                juce::dsp::AudioBlock<float> audioBlock(buffer);
+                detune.process(audioBlock);
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = juce::jmin(best, elapsed.count() / (static_cast<double>(numBlocks) * blockSize));
+        }
+
+        return best;
+    }
+};
+
+static MicroPitchDetuneEngineBenchmark microPitchDetuneEngineBenchmark;
@@ -0,0 +1,156 @@
+#include "MicroPitchDetune.h"
+#include <cmath>
+
+//==============================================================================
+// Nulls the optimised voice kernels against the plain per-sample reference
+// kernel. Both instances share a seed, so any difference is down to the
+// kernels themselves.
+class MicroPitchDetuneNullTest : public juce::UnitTest
+{
+public:
+    MicroPitchDetuneNullTest() : juce::UnitTest("MicroPitchDetune null", "EchoPsychFX") {}
+
+    void runTest() override
+    {
+        constexpr double maxNullDb = -96.0;
+
+        for (const int numVoices : { 1, 3, 8 })
+        {
+            for (const float feedback : { 0.0f, 0.5f })
+            {
+                beginTest(juce::String(numVoices) + " voices, feedback " + juce::String(feedback, 1));
+
+                const double null = measureNull(numVoices, feedback);
+                logMessage("optimised against reference: " + juce::String(null, 1) + " dB");
+
+                expectLessThan(null, maxNullDb, "Optimised kernel does not null against the reference");
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int numBlocks = 300;
+
+    // Peak difference relative to the peak output, in dB
+    static double measureNull(int numVoices, float feedback)
+    {
+        MicroPitchDetune optimised;
+        MicroPitchDetune reference;
+        reference.setUseReferenceKernel(true);
+
+        for (auto* detune : { &optimised, &reference })
+        {
+            detune->prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 2 });
+            detune->setSeed(9);
+            detune->setNumVoices(numVoices);
+            detune->reset();
+            detune->setParams(15.0f, 0.7f, 0.004f, 0.006f, 0.5f, 1.0f, feedback, 0.6f);
+        }
+
+        juce::AudioBuffer<float> optimisedBuffer(2, blockSize);
+        juce::AudioBuffer<float> referenceBuffer(2, blockSize);
+        double maxError = 0.0;
+        double peak = 0.0;
+        int sample = 0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i, ++sample)
+            {
+                const float left = 0.5f * std::sin(0.05f * static_cast<float>(sample)) + 0.2f;
+                const float right = 0.5f * std::sin(0.0031f * static_cast<float>(sample));
+
+                for (auto* buffer : { &optimisedBuffer, &referenceBuffer })
+                {
+                    buffer->setSample(0, i, left);
+                    buffer->setSample(1, i, right);
+                }
+            }
+
+            juce::dsp::AudioBlock<float> optimisedBlock(optimisedBuffer);
+            juce::dsp::AudioBlock<float> referenceBlock(referenceBuffer);
+            optimised.process(optimisedBlock);
+            reference.process(referenceBlock);
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const double expected = referenceBuffer.getSample(channel, i);
+                    maxError = juce::jmax(maxError, std::abs(optimisedBuffer.getSample(channel, i) - expected));
+                    peak = juce::jmax(peak, std::abs(expected));
+                }
+            }
+        }
+
+        return 20.0 * std::log10(juce::jmax(maxError, 1.0e-12) / peak);
+    }
+};
+
+static MicroPitchDetuneNullTest microPitchDetuneNullTest;
+
+//==============================================================================
+// At 0 cents the granular engine's heads stand still, so its wet output has
+// to be the input delayed by exactly the reported latency, on both channels
+// and whatever the stereo separation.
+class MicroPitchDetuneGranularLatencyTest : public juce::UnitTest
+{
+public:
+    MicroPitchDetuneGranularLatencyTest() : juce::UnitTest("MicroPitchDetune granular latency", "EchoPsychFX") {}
+
+    void runTest() override
+    {
+        constexpr double maxErrorDb = -90.0;
+
+        for (const float separation : { 0.0f, 0.5f, 1.0f })
+        {
+            beginTest("0 cents, separation " + juce::String(separation, 1));
+
+            MicroPitchDetune detune;
+            detune.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 2 });
+            detune.setEngine(MicroPitchDetune::Engine::Granular);
+            detune.setParams(0.0f, 0.7f, 0.004f, 0.006f, separation, 1.0f, 0.0f, 0.0f);
+            detune.reset();
+
+            const int latency = detune.getLatencySamples();
+            const int totalSamples = numBlocks * blockSize;
+            juce::AudioBuffer<float> input(2, totalSamples);
+
+            for (int i = 0; i < totalSamples; ++i)
+            {
+                input.setSample(0, i, 0.5f * std::sin(0.05f * static_cast<float>(i)));
+                input.setSample(1, i, 0.5f * std::sin(0.31f * static_cast<float>(i)));
+            }
+
+            juce::AudioBuffer<float> output(input);
+            juce::dsp::AudioBlock<float> block(output);
+            for (int start = 0; start < totalSamples; start += blockSize)
+            {
+                auto subBlock = block.getSubBlock(static_cast<size_t>(start), static_cast<size_t>(blockSize));
+                detune.process(subBlock);
+            }
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                double maxError = 0.0;
+                for (int i = latency; i < totalSamples; ++i)
+                    maxError = juce::jmax(maxError, static_cast<double>(std::abs(output.getSample(channel, i)
+                        - input.getSample(channel, i - latency))));
+
+                const double errorDb = 20.0 * std::log10(juce::jmax(maxError, 1.0e-12) / 0.5);
+                logMessage((channel == 0 ? "left" : "right") + juce::String(" against the delayed input: ")
+                    + juce::String(errorDb, 1) + " dB");
+                expectLessThan(errorDb, maxErrorDb, "wet path is off the reported latency");
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int numBlocks = 40;
+};
+
+static MicroPitchDetuneGranularLatencyTest microPitchDetuneGranularLatencyTest;
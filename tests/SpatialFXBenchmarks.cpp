@@ -0,0 +1,71 @@
+#include "SpatialFX.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+//==============================================================================
+// Per-sample cost of the two phase modes. Everything else in the chain is
+// set up the same way, so the difference between the two is the Hilbert
+// network's cost over the rotation.
+class SpatialFXPhaseModeBenchmark : public juce::UnitTest
+{
+public:
+    SpatialFXPhaseModeBenchmark() : juce::UnitTest("SpatialFX phase mode cost", "EchoPsychFX Benchmarks") {}
+
+    void runTest() override
+    {
+        beginTest("Rotation against Hilbert");
+
+        const double rotation = measureNanosecondsPerSample(SpatialFX::PhaseMode::Rotation);
+        const double hilbert = measureNanosecondsPerSample(SpatialFX::PhaseMode::Hilbert);
+
+        logMessage("ns per stereo sample: rotation " + juce::String(rotation, 1) + ", Hilbert "
+            + juce::String(hilbert, 1) + " (+" + juce::String(hilbert - rotation, 1) + ")");
+
+        expect(std::isfinite(rotation) && std::isfinite(hilbert));
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int numBlocks = 2000;
+    static constexpr int numRuns = 5;
+
+    // Best of several runs, so a preempted run doesn't count
+    static double measureNanosecondsPerSample(SpatialFX::PhaseMode mode)
+    {
+        SpatialFX spatial;
+        spatial.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 2 });
+        spatial.setPhaseMode(mode);
+        spatial.setPhaseAmount(1.0f, -1.0f);
+        spatial.setLfoDepth(0.5f, 0.5f);
+        spatial.setLfoRate(0.5f, 0.7f);
+        spatial.setWetDry(1.0f);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (int i = 0; i < blockSize; ++i)
+        {
+            buffer.setSample(0, i, 0.5f * std::sin(0.05f * static_cast<float>(i)));
+            buffer.setSample(1, i, 0.5f * std::sin(0.031f * static_cast<float>(i)));
+        }
+
+        double best = std::numeric_limits<double>::max();
+        for (int run = 0; run < numRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                juce::dsp::AudioBlock<float> audioBlock(buffer);
+                spatial.process(audioBlock);
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = juce::jmin(best, elapsed.count() / (static_cast<double>(numBlocks) * blockSize));
+        }
+
+        return best;
+    }
+};
+
+static SpatialFXPhaseModeBenchmark spatialFXPhaseModeBenchmark;
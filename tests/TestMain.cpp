@@ -0,0 +1,18 @@
+#include <juce_core/juce_core.h>
+
+// Runs every EchoPsychFX unit test; a non-zero exit code means a failure.
+// With --benchmarks it runs the timing benchmarks instead.
+int main(int argc, char* argv[])
+{
+    const bool runBenchmarks = argc > 1 && juce::String(argv[1]) == "--benchmarks";
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory(runBenchmarks ? "EchoPsychFX Benchmarks" : "EchoPsychFX");
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}